@@ -21,15 +21,65 @@
 #include "config.h"
 #include "WPEQmlExtensionPlugin.h"
 
+#include "WPEQtDownloadModel.h"
+#include "WPEQtFrameStream.h"
+#include "WPEQtGeolocation.h"
+#include "WPEQtLoadScheduler.h"
+#include "WPEQtMemoryPressureSettings.h"
+#include "WPEQtNewViewRequest.h"
+#include "WPEQtPermissionRequest.h"
+#include "WPEQtProcessMonitor.h"
+#include "WPEQtProfile.h"
+#include "WPEQtUserContent.h"
 #include "WPEQtView.h"
 #include "WPEQtViewLoadRequest.h"
+#include "WPEQtWebChannel.h"
+#include <QQmlEngine>
 #include <qqml.h>
 
 void WPEQmlExtensionPlugin::registerTypes(const char* uri)
 {
     // @uri org.wpewebkit.qtwpe
     qmlRegisterType<WPEQtView>(uri, 1, 0, "WPEView");
+    qmlRegisterType<WPEQtFrameStream>(uri, 1, 0, "WPEFrameStream");
+    qmlRegisterType<WPEQtProfile>(uri, 1, 0, "WPEProfile");
+    qmlRegisterType<WPEQtUserScript>(uri, 1, 0, "WPEUserScript");
+    qmlRegisterType<WPEQtUserStyleSheet>(uri, 1, 0, "WPEUserStyleSheet");
+    qmlRegisterType<WPEQtWebChannel>(uri, 1, 0, "WPEWebChannel");
+    qmlRegisterSingletonType<WPEQtGeolocation>(uri, 1, 0, "WPEGeolocation", [](QQmlEngine*, QJSEngine*) -> QObject* {
+        auto* geolocation = WPEQtGeolocation::singleton();
+        QQmlEngine::setObjectOwnership(geolocation, QQmlEngine::CppOwnership);
+        return geolocation;
+    });
+    qmlRegisterSingletonType<WPEQtLoadScheduler>(uri, 1, 0, "WPELoadScheduler", [](QQmlEngine*, QJSEngine*) -> QObject* {
+        auto* scheduler = WPEQtLoadScheduler::singleton();
+        QQmlEngine::setObjectOwnership(scheduler, QQmlEngine::CppOwnership);
+        return scheduler;
+    });
+    qmlRegisterSingletonType<WPEQtProcessMonitor>(uri, 1, 0, "WPEProcessMonitor", [](QQmlEngine*, QJSEngine*) -> QObject* {
+        auto* monitor = WPEQtProcessMonitor::singleton();
+        QQmlEngine::setObjectOwnership(monitor, QQmlEngine::CppOwnership);
+        return monitor;
+    });
 
     const QString& msg = QObject::tr("Cannot create separate instance of WPEQtViewLoadRequest");
     qmlRegisterUncreatableType<WPEQtViewLoadRequest>(uri, 1, 0, "WPEViewLoadRequest", msg);
+
+    const QString& newViewRequestMsg = QObject::tr("Cannot create separate instance of WPEQtNewViewRequest");
+    qmlRegisterUncreatableType<WPEQtNewViewRequest>(uri, 1, 0, "WPENewViewRequest", newViewRequestMsg);
+
+    const QString& permissionRequestMsg = QObject::tr("Cannot create separate instance of WPEQtPermissionRequest");
+    qmlRegisterUncreatableType<WPEQtPermissionRequest>(uri, 1, 0, "WPEPermissionRequest", permissionRequestMsg);
+
+    const QString& downloadModelMsg = QObject::tr("Cannot create separate instance of WPEQtDownloadModel");
+    qmlRegisterUncreatableType<WPEQtDownloadModel>(uri, 1, 0, "WPEDownloadModel", downloadModelMsg);
+
+    const QString& memoryPressureSettingsMsg = QObject::tr("Cannot create separate instance of WPEQtMemoryPressureSettings");
+    qmlRegisterUncreatableType<WPEQtMemoryPressureSettings>(uri, 1, 0, "WPEMemoryPressureSettings", memoryPressureSettingsMsg);
+
+    const QString& userContentMsg = QObject::tr("Cannot create separate instance of WPEQtUserContent");
+    qmlRegisterUncreatableType<WPEQtUserContent>(uri, 1, 0, "WPEUserContent", userContentMsg);
+
+    const QString& processInfoMsg = QObject::tr("Cannot create separate instance of WPEQtProcessInfo");
+    qmlRegisterUncreatableType<WPEQtProcessInfo>(uri, 1, 0, "WPEProcessInfo", processInfoMsg);
 }
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtBackendFactory.h"
+
+#include <QOpenGLFunctions>
+#include <wpe/fdo-egl.h>
+#include <wpe/fdo.h>
+
+WPEQtBackendFactory& WPEQtBackendFactory::singleton()
+{
+    static WPEQtBackendFactory factory;
+    return factory;
+}
+
+bool WPEQtBackendFactory::initialize(EGLDisplay eglDisplay)
+{
+    if (eglDisplay == EGL_NO_DISPLAY)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_eglContext != EGL_NO_CONTEXT) {
+        // Backends of existing views keep using the shared context, and
+        // WPEBackend-fdo cannot be set up again for another display.
+        if (m_eglDisplay != eglDisplay)
+            qWarning("WPEView: EGL display changed, views can only be created for the display of the first view");
+        return m_eglDisplay == eglDisplay;
+    }
+
+    if (!m_loaderInitialized) {
+        wpe_loader_init("libWPEBackend-fdo-1.0.so");
+        m_imageTargetTexture2DOES = reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+        m_loaderInitialized = true;
+    }
+
+    eglInitialize(eglDisplay, nullptr, nullptr);
+
+    if (!eglBindAPI(EGL_OPENGL_ES_API) || !wpe_fdo_initialize_for_egl_display(eglDisplay))
+        return false;
+
+    static const EGLint configAttributes[13] = {
+        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+        EGL_RED_SIZE, 1,
+        EGL_GREEN_SIZE, 1,
+        EGL_BLUE_SIZE, 1,
+        EGL_ALPHA_SIZE, 1,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE
+    };
+
+    EGLint count = 0;
+    if (!eglGetConfigs(eglDisplay, nullptr, 0, &count) || count < 1)
+        return false;
+
+    EGLConfig eglConfig;
+    EGLint matched = 0;
+    EGLContext eglContext = EGL_NO_CONTEXT;
+    if (eglChooseConfig(eglDisplay, configAttributes, &eglConfig, 1, &matched) && !!matched) {
+        static const EGLint contextAttributes[3] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+        eglContext = eglCreateContext(eglDisplay, eglConfig, nullptr, contextAttributes);
+    }
+
+    if (eglContext == EGL_NO_CONTEXT)
+        return false;
+
+    m_eglDisplay = eglDisplay;
+    m_eglContext = eglContext;
+    return true;
+}
+
+EGLContext WPEQtBackendFactory::sharedContext() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_eglContext;
+}
+
+WPEQtBackendFactory::Program WPEQtBackendFactory::program(QOpenGLContext* context)
+{
+    QMutexLocker locker(&m_mutex);
+    auto* shareGroup = context->shareGroup();
+    auto it = m_programs.find(shareGroup);
+    if (it != m_programs.end())
+        return it.value();
+
+    Program program = linkProgram(context);
+    m_programs.insert(shareGroup, program);
+    QObject::connect(shareGroup, &QObject::destroyed, [this, shareGroup] {
+        QMutexLocker locker(&m_mutex);
+        m_programs.remove(shareGroup);
+    });
+    return program;
+}
+
+WPEQtBackendFactory::Program WPEQtBackendFactory::linkProgram(QOpenGLContext* context)
+{
+    static const char* vertexShaderSource =
+        "attribute vec2 pos;\n"
+        "attribute vec2 texture;\n"
+        "varying vec2 v_texture;\n"
+        "void main() {\n"
+        "  v_texture = texture;\n"
+        "  gl_Position = vec4(pos, 0, 1);\n"
+        "}\n";
+    static const char* fragmentShaderSource =
+        "precision mediump float;\n"
+        "uniform sampler2D u_texture;\n"
+        "varying vec2 v_texture;\n"
+        "void main() {\n"
+        "  gl_FragColor = texture2D(u_texture, v_texture);\n"
+        "}\n";
+
+    QOpenGLFunctions* glFunctions = context->functions();
+    GLuint vertexShader = glFunctions->glCreateShader(GL_VERTEX_SHADER);
+    glFunctions->glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
+    glFunctions->glCompileShader(vertexShader);
+
+    GLuint fragmentShader = glFunctions->glCreateShader(GL_FRAGMENT_SHADER);
+    glFunctions->glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glFunctions->glCompileShader(fragmentShader);
+
+    Program program;
+    program.id = glFunctions->glCreateProgram();
+    glFunctions->glAttachShader(program.id, vertexShader);
+    glFunctions->glAttachShader(program.id, fragmentShader);
+    glFunctions->glBindAttribLocation(program.id, 0, "pos");
+    glFunctions->glBindAttribLocation(program.id, 1, "texture");
+    glFunctions->glLinkProgram(program.id);
+
+    // The linked program keeps the compiled code alive, the shader objects are no longer needed.
+    glFunctions->glDeleteShader(vertexShader);
+    glFunctions->glDeleteShader(fragmentShader);
+
+    program.textureUniform = glFunctions->glGetUniformLocation(program.id, "u_texture");
+    return program;
+}
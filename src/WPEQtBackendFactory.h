@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+// This include order is necessary to enforce the GBM EGL platform.
+#include <gbm.h>
+#include <epoxy/egl.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QOpenGLContext>
+
+class WPEQtBackendFactory {
+public:
+    static WPEQtBackendFactory& singleton();
+
+    // Performs the one-time EGL, libwpe and WPEBackend-fdo setup for the display.
+    // Thread-safe; subsequent calls for the same display return the cached result.
+    // The setup is done for a single display per process, other displays are refused.
+    bool initialize(EGLDisplay);
+
+    EGLContext sharedContext() const;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture2DOES() const { return m_imageTargetTexture2DOES; };
+
+    struct Program {
+        unsigned id { 0 };
+        unsigned textureUniform { 0 };
+    };
+
+    // Returns the program linked for the share group of the given context, which
+    // must be current. Programs are linked once per share group and shared by all views.
+    Program program(QOpenGLContext*);
+
+private:
+    WPEQtBackendFactory() = default;
+    Program linkProgram(QOpenGLContext*);
+
+    mutable QMutex m_mutex;
+    EGLDisplay m_eglDisplay { EGL_NO_DISPLAY };
+    EGLContext m_eglContext { EGL_NO_CONTEXT };
+    bool m_loaderInitialized { false };
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC m_imageTargetTexture2DOES { nullptr };
+    QHash<QOpenGLContextGroup*, Program> m_programs;
+};
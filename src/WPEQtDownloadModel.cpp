@@ -0,0 +1,541 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtDownloadModel.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QStorageInfo>
+#include <algorithm>
+
+// Free space is checked again every time this much data was received.
+static const qint64 freeSpaceCheckInterval = 8 * 1024 * 1024;
+
+/*!
+  \qmltype WPEDownloadModel
+  \instantiates WPEQtDownloadModel
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A model of the downloads of a \l WPEProfile.
+
+  WPEDownloadModel lists the downloads started by the views of a profile,
+  most recent last. WebKit streams the downloaded data to the destination
+  file in the network process.
+
+  At most \l maxConcurrentDownloads downloads receive data at the same
+  time, the other ones stay \c Queued until a running download completes.
+  Downloads are also kept queued while the destination file system has less
+  than \l minimumFreeSpace bytes left, counting the announced size of the
+  download, and running downloads fail when they get below it.
+
+  The model provides the following roles:
+
+  \table
+  \header \li Role \li Description
+  \row \li url \li The URL of the download.
+  \row \li destination \li The path of the destination file.
+  \row \li fileName \li The name of the destination file.
+  \row \li mimeType \li The MIME type of the downloaded data.
+  \row \li state \li One of \c Queued, \c Downloading, \c Finished, \c Failed and \c Cancelled.
+  \row \li receivedBytes \li The amount of data received.
+  \row \li totalBytes \li The size of the download, or \c -1 if unknown.
+  \row \li progress \li The progress of the download, between \c 0 and \c 1.
+  \row \li throughput \li The current download speed, in bytes per second.
+  \row \li errorString \li The error message of a failed download.
+  \endtable
+
+  The progress related roles are updated twice a second.
+
+  \badcode
+  ListView {
+      model: profile.downloads
+      delegate: ProgressBar { value: progress }
+  }
+  \endcode
+*/
+WPEQtDownloadModel::WPEQtDownloadModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    m_sampleTimer.setInterval(500);
+    connect(&m_sampleTimer, &QTimer::timeout, this, &WPEQtDownloadModel::sampleThroughput);
+}
+
+WPEQtDownloadModel::~WPEQtDownloadModel()
+{
+    for (auto& session : m_sessions)
+        g_signal_handlers_disconnect_by_func(session.get(), reinterpret_cast<gpointer>(downloadStartedCallback), this);
+    for (auto& entry : m_downloads) {
+        if (entry.download)
+            disconnectDownload(entry.download.get());
+    }
+}
+
+void WPEQtDownloadModel::attachSession(WebKitNetworkSession* session)
+{
+    m_sessions.push_back(session);
+    g_signal_connect(session, "download-started", G_CALLBACK(downloadStartedCallback), this);
+}
+
+void WPEQtDownloadModel::disconnectDownload(WebKitDownload* download)
+{
+    g_signal_handlers_disconnect_by_func(download, reinterpret_cast<gpointer>(decideDestinationCallback), this);
+    g_signal_handlers_disconnect_by_func(download, reinterpret_cast<gpointer>(receivedDataCallback), this);
+    g_signal_handlers_disconnect_by_func(download, reinterpret_cast<gpointer>(finishedCallback), this);
+    g_signal_handlers_disconnect_by_func(download, reinterpret_cast<gpointer>(failedCallback), this);
+}
+
+/*!
+  \qmlproperty string WPEDownloadModel::downloadDirectory
+
+  The directory downloads are saved to when their destination is not set
+  with \l setDestination(). Defaults to the download directory of the user.
+*/
+QString WPEQtDownloadModel::downloadDirectory() const
+{
+    if (!m_downloadDirectory.isEmpty())
+        return m_downloadDirectory;
+    return QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
+}
+
+void WPEQtDownloadModel::setDownloadDirectory(const QString& downloadDirectory)
+{
+    if (downloadDirectory == m_downloadDirectory)
+        return;
+
+    m_downloadDirectory = downloadDirectory;
+    Q_EMIT downloadDirectoryChanged();
+}
+
+/*!
+  \qmlproperty int WPEDownloadModel::maxConcurrentDownloads
+
+  The maximum number of downloads receiving data at the same time, so that
+  downloads do not starve page loads. The default value is \c 2.
+*/
+void WPEQtDownloadModel::setMaxConcurrentDownloads(int maxConcurrentDownloads)
+{
+    maxConcurrentDownloads = std::max(maxConcurrentDownloads, 1);
+    if (maxConcurrentDownloads == m_maxConcurrentDownloads)
+        return;
+
+    m_maxConcurrentDownloads = maxConcurrentDownloads;
+    startQueuedDownloads();
+    Q_EMIT maxConcurrentDownloadsChanged();
+}
+
+/*!
+  \qmlproperty real WPEDownloadModel::minimumFreeSpace
+
+  The amount of space, in bytes, that downloads leave free on the
+  destination file system. The default value is 64 MiB.
+*/
+void WPEQtDownloadModel::setMinimumFreeSpace(qint64 minimumFreeSpace)
+{
+    minimumFreeSpace = std::max<qint64>(minimumFreeSpace, 0);
+    if (minimumFreeSpace == m_minimumFreeSpace)
+        return;
+
+    m_minimumFreeSpace = minimumFreeSpace;
+    startQueuedDownloads();
+    Q_EMIT minimumFreeSpaceChanged();
+}
+
+/*!
+  \qmlproperty int WPEDownloadModel::activeCount
+  \readonly
+
+  The number of downloads receiving data.
+*/
+int WPEQtDownloadModel::activeCount() const
+{
+    return std::count_if(m_downloads.begin(), m_downloads.end(), [](const Download& entry) {
+        return entry.state == Downloading;
+    });
+}
+
+int WPEQtDownloadModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_downloads.size());
+}
+
+QVariant WPEQtDownloadModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const auto& entry = m_downloads[index.row()];
+    switch (role) {
+    case UrlRole:
+        return entry.url;
+    case DestinationRole:
+        return entry.destination;
+    case Qt::DisplayRole:
+    case FileNameRole:
+        return QFileInfo(entry.destination).fileName();
+    case MimeTypeRole:
+        return entry.mimeType;
+    case StateRole:
+        return entry.state;
+    case ReceivedBytesRole:
+        return entry.receivedBytes;
+    case TotalBytesRole:
+        return entry.totalBytes;
+    case ProgressRole:
+        if (entry.state == Finished)
+            return 1.0;
+        return entry.totalBytes > 0 ? std::min(1.0, static_cast<qreal>(entry.receivedBytes) / entry.totalBytes) : 0.0;
+    case ThroughputRole:
+        return entry.throughput;
+    case ErrorStringRole:
+        return entry.errorString;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> WPEQtDownloadModel::roleNames() const
+{
+    return {
+        { UrlRole, "url" },
+        { DestinationRole, "destination" },
+        { FileNameRole, "fileName" },
+        { MimeTypeRole, "mimeType" },
+        { StateRole, "state" },
+        { ReceivedBytesRole, "receivedBytes" },
+        { TotalBytesRole, "totalBytes" },
+        { ProgressRole, "progress" },
+        { ThroughputRole, "throughput" },
+        { ErrorStringRole, "errorString" }
+    };
+}
+
+int WPEQtDownloadModel::indexOf(WebKitDownload* download) const
+{
+    auto it = std::find_if(m_downloads.begin(), m_downloads.end(), [download](const Download& entry) {
+        return entry.download.get() == download;
+    });
+    return it != m_downloads.end() ? static_cast<int>(it - m_downloads.begin()) : -1;
+}
+
+void WPEQtDownloadModel::setState(int index, State state)
+{
+    auto& entry = m_downloads[index];
+    const bool wasActive = entry.state == Downloading;
+    entry.state = state;
+
+    if (state != Queued && state != Downloading && entry.download) {
+        disconnectDownload(entry.download.get());
+        entry.download = nullptr;
+        entry.throughput = 0;
+    }
+
+    const QModelIndex modelIndex = this->index(index);
+    Q_EMIT dataChanged(modelIndex, modelIndex);
+    if (wasActive != (state == Downloading))
+        Q_EMIT activeCountChanged();
+}
+
+/*!
+  \qmlmethod bool WPEDownloadModel::setDestination(int index, string path)
+
+  Sets the destination file of the download at \a index. This is only
+  possible while the download is queued, typically from a
+  \l downloadAdded() handler. Returns \c false otherwise.
+*/
+bool WPEQtDownloadModel::setDestination(int index, const QString& path)
+{
+    if (index < 0 || index >= rowCount() || m_downloads[index].state != Queued || path.isEmpty())
+        return false;
+
+    m_downloads[index].destination = QFileInfo(path).absoluteFilePath();
+    const QModelIndex modelIndex = this->index(index);
+    Q_EMIT dataChanged(modelIndex, modelIndex, { DestinationRole, FileNameRole });
+    return true;
+}
+
+/*!
+  \qmlmethod void WPEDownloadModel::cancel(int index)
+
+  Cancels the download at \a index. The partially downloaded file is removed.
+*/
+void WPEQtDownloadModel::cancel(int index)
+{
+    if (index < 0 || index >= rowCount())
+        return;
+
+    auto& entry = m_downloads[index];
+    if (entry.download)
+        webkit_download_cancel(entry.download.get());
+}
+
+/*!
+  \qmlmethod void WPEDownloadModel::remove(int index)
+
+  Removes the download at \a index from the model, cancelling it if it did
+  not complete. Downloaded files are kept.
+*/
+void WPEQtDownloadModel::remove(int index)
+{
+    if (index < 0 || index >= rowCount())
+        return;
+
+    GRefPtr<WebKitDownload> download = m_downloads[index].download;
+    const bool wasActive = m_downloads[index].state == Downloading;
+    if (download)
+        disconnectDownload(download.get());
+
+    beginRemoveRows(QModelIndex(), index, index);
+    m_downloads.erase(m_downloads.begin() + index);
+    endRemoveRows();
+    Q_EMIT countChanged();
+
+    if (download)
+        webkit_download_cancel(download.get());
+    if (wasActive) {
+        Q_EMIT activeCountChanged();
+        startQueuedDownloads();
+    }
+}
+
+/*!
+  \qmlmethod void WPEDownloadModel::clearFinished()
+
+  Removes the completed, failed and cancelled downloads from the model.
+*/
+void WPEQtDownloadModel::clearFinished()
+{
+    for (int i = rowCount() - 1; i >= 0; --i) {
+        if (m_downloads[i].state != Queued && m_downloads[i].state != Downloading)
+            remove(i);
+    }
+}
+
+bool WPEQtDownloadModel::hasFreeSpace(const Download& entry) const
+{
+    QStorageInfo storage(QFileInfo(entry.destination).absolutePath());
+    if (!storage.isValid())
+        return true;
+
+    const qint64 remaining = entry.totalBytes > 0 ? std::max<qint64>(entry.totalBytes - entry.receivedBytes, 0) : 0;
+    return storage.bytesAvailable() >= m_minimumFreeSpace + remaining;
+}
+
+QString WPEQtDownloadModel::uniqueDestination(const QString& suggestedFileName) const
+{
+    QString fileName = QFileInfo(suggestedFileName).fileName();
+    if (fileName.isEmpty() || fileName.startsWith(QLatin1Char('.')))
+        fileName.prepend(QStringLiteral("download"));
+
+    const QDir directory(downloadDirectory());
+    const QFileInfo info(fileName);
+    const QString baseName = info.completeBaseName();
+    const QString suffix = info.suffix().isEmpty() ? QString() : QLatin1Char('.') + info.suffix();
+
+    auto isTaken = [this](const QString& path) {
+        return QFileInfo::exists(path) || std::any_of(m_downloads.begin(), m_downloads.end(), [&path](const Download& entry) {
+            return entry.destination == path;
+        });
+    };
+
+    QString path = directory.absoluteFilePath(fileName);
+    for (int i = 1; isTaken(path); ++i)
+        path = directory.absoluteFilePath(QStringLiteral("%1 (%2)%3").arg(baseName).arg(i).arg(suffix));
+    return path;
+}
+
+void WPEQtDownloadModel::startQueuedDownloads()
+{
+    int active = activeCount();
+    bool waitingForSpace = false;
+    for (int i = 0; i < rowCount() && active < m_maxConcurrentDownloads; ++i) {
+        auto& entry = m_downloads[i];
+        if (entry.state != Queued || !entry.destinationPending)
+            continue;
+
+        if (!hasFreeSpace(entry)) {
+            waitingForSpace = true;
+            continue;
+        }
+
+        QDir().mkpath(QFileInfo(entry.destination).absolutePath());
+        entry.destinationPending = false;
+        webkit_download_set_allow_overwrite(entry.download.get(), FALSE);
+        webkit_download_set_destination(entry.download.get(), entry.destination.toUtf8().constData());
+        setState(i, Downloading);
+        active++;
+    }
+
+    // Sampling also retries the downloads waiting for disk space.
+    if (active || waitingForSpace) {
+        if (!m_sampleTimer.isActive()) {
+            m_sinceLastSample.start();
+            m_sampleTimer.start();
+        }
+    } else
+        m_sampleTimer.stop();
+}
+
+void WPEQtDownloadModel::sampleThroughput()
+{
+    const qreal elapsed = std::max<qint64>(m_sinceLastSample.restart(), 1) / 1000.;
+    for (int i = 0; i < rowCount(); ++i) {
+        auto& entry = m_downloads[i];
+        if (entry.state != Downloading)
+            continue;
+
+        const qreal throughput = (entry.receivedBytes - entry.sampledBytes) / elapsed;
+        entry.throughput = entry.throughput ? 0.7 * entry.throughput + 0.3 * throughput : throughput;
+        entry.sampledBytes = entry.receivedBytes;
+        const QModelIndex modelIndex = index(i);
+        Q_EMIT dataChanged(modelIndex, modelIndex, { ReceivedBytesRole, ProgressRole, ThroughputRole });
+    }
+    startQueuedDownloads();
+}
+
+void WPEQtDownloadModel::downloadStartedCallback(WebKitNetworkSession*, WebKitDownload* download, WPEQtDownloadModel* model)
+{
+    Download entry;
+    entry.download = download;
+    if (auto* request = webkit_download_get_request(download))
+        entry.url = QUrl(QString::fromUtf8(webkit_uri_request_get_uri(request)));
+
+    g_signal_connect(download, "decide-destination", G_CALLBACK(decideDestinationCallback), model);
+    g_signal_connect(download, "received-data", G_CALLBACK(receivedDataCallback), model);
+    g_signal_connect(download, "finished", G_CALLBACK(finishedCallback), model);
+    g_signal_connect(download, "failed", G_CALLBACK(failedCallback), model);
+
+    const int index = model->rowCount();
+    model->beginInsertRows(QModelIndex(), index, index);
+    model->m_downloads.push_back(std::move(entry));
+    model->endInsertRows();
+    Q_EMIT model->countChanged();
+}
+
+// WebKit keeps the data of the download until a destination is set, which
+// is how downloads are queued.
+gboolean WPEQtDownloadModel::decideDestinationCallback(WebKitDownload* download, const gchar* suggestedFileName, WPEQtDownloadModel* model)
+{
+    const int index = model->indexOf(download);
+    if (index < 0)
+        return FALSE;
+
+    auto& entry = model->m_downloads[index];
+    if (auto* response = webkit_download_get_response(download)) {
+        entry.url = QUrl(QString::fromUtf8(webkit_uri_response_get_uri(response)));
+        entry.mimeType = QString::fromUtf8(webkit_uri_response_get_mime_type(response));
+        if (const guint64 contentLength = webkit_uri_response_get_content_length(response))
+            entry.totalBytes = contentLength;
+    }
+
+    const QString fileName = QString::fromUtf8(suggestedFileName);
+    Q_EMIT model->downloadAdded(index, fileName);
+
+    // The handler may have removed or cancelled the download.
+    const int currentIndex = model->indexOf(download);
+    if (currentIndex < 0 || model->m_downloads[currentIndex].state != Queued)
+        return TRUE;
+
+    auto& current = model->m_downloads[currentIndex];
+    if (current.destination.isEmpty())
+        current.destination = model->uniqueDestination(fileName);
+    current.destinationPending = true;
+    const QModelIndex modelIndex = model->index(currentIndex);
+    Q_EMIT model->dataChanged(modelIndex, modelIndex);
+
+    model->startQueuedDownloads();
+    return TRUE;
+}
+
+void WPEQtDownloadModel::receivedDataCallback(WebKitDownload* download, guint64, WPEQtDownloadModel* model)
+{
+    const int index = model->indexOf(download);
+    if (index < 0)
+        return;
+
+    auto& entry = model->m_downloads[index];
+    entry.receivedBytes = webkit_download_get_received_data_length(download);
+    if (entry.receivedBytes - entry.checkedBytes < freeSpaceCheckInterval)
+        return;
+
+    entry.checkedBytes = entry.receivedBytes;
+    if (!model->hasFreeSpace(entry)) {
+        entry.errorString = tr("Not enough disk space");
+        webkit_download_cancel(download);
+    }
+}
+
+void WPEQtDownloadModel::finishedCallback(WebKitDownload* download, WPEQtDownloadModel* model)
+{
+    const int index = model->indexOf(download);
+    if (index < 0)
+        return;
+
+    auto& entry = model->m_downloads[index];
+    entry.receivedBytes = webkit_download_get_received_data_length(download);
+    if (entry.totalBytes < 0)
+        entry.totalBytes = entry.receivedBytes;
+    if (const char* destination = webkit_download_get_destination(download))
+        entry.destination = QString::fromUtf8(destination);
+    model->setState(index, Finished);
+    Q_EMIT model->downloadFinished(index);
+    model->startQueuedDownloads();
+}
+
+void WPEQtDownloadModel::failedCallback(WebKitDownload* download, GError* error, WPEQtDownloadModel* model)
+{
+    const int index = model->indexOf(download);
+    if (index < 0)
+        return;
+
+    // WebKit emits "finished" after "failed", which is ignored once disconnected.
+    auto& entry = model->m_downloads[index];
+    const bool cancelled = g_error_matches(error, WEBKIT_DOWNLOAD_ERROR, WEBKIT_DOWNLOAD_ERROR_CANCELLED_BY_USER);
+    if (cancelled && entry.errorString.isEmpty()) {
+        model->setState(index, Cancelled);
+    } else {
+        if (entry.errorString.isEmpty())
+            entry.errorString = QString::fromUtf8(error->message);
+        model->setState(index, Failed);
+        Q_EMIT model->downloadFailed(index, entry.errorString);
+    }
+    model->startQueuedDownloads();
+}
+
+/*!
+  \qmlsignal WPEDownloadModel::downloadAdded(int index, string suggestedFileName)
+
+  This signal is emitted when the download at \a index received its
+  response, before it is queued. Handlers may call \l setDestination() to
+  choose where the download is saved, or \l cancel() to refuse it. By default
+  downloads are saved to \l downloadDirectory as \a suggestedFileName.
+*/
+
+/*!
+  \qmlsignal WPEDownloadModel::downloadFinished(int index)
+
+  This signal is emitted when the download at \a index completed.
+*/
+
+/*!
+  \qmlsignal WPEDownloadModel::downloadFailed(int index, string errorString)
+
+  This signal is emitted when the download at \a index failed.
+*/
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QUrl>
+#include <vector>
+#include <wpe/webkit.h>
+#include <wtf/glib/GRefPtr.h>
+
+class WPEQtDownloadModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtDownloadModel)
+    Q_PROPERTY(QString downloadDirectory READ downloadDirectory WRITE setDownloadDirectory NOTIFY downloadDirectoryChanged)
+    Q_PROPERTY(int maxConcurrentDownloads READ maxConcurrentDownloads WRITE setMaxConcurrentDownloads NOTIFY maxConcurrentDownloadsChanged)
+    Q_PROPERTY(qint64 minimumFreeSpace READ minimumFreeSpace WRITE setMinimumFreeSpace NOTIFY minimumFreeSpaceChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY activeCountChanged)
+    Q_ENUMS(State)
+
+public:
+    enum State {
+        Queued,
+        Downloading,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    enum Role {
+        UrlRole = Qt::UserRole + 1,
+        DestinationRole,
+        FileNameRole,
+        MimeTypeRole,
+        StateRole,
+        ReceivedBytesRole,
+        TotalBytesRole,
+        ProgressRole,
+        ThroughputRole,
+        ErrorStringRole
+    };
+
+    explicit WPEQtDownloadModel(QObject* parent = nullptr);
+    ~WPEQtDownloadModel();
+
+    void attachSession(WebKitNetworkSession*);
+
+    QString downloadDirectory() const;
+    void setDownloadDirectory(const QString&);
+    int maxConcurrentDownloads() const { return m_maxConcurrentDownloads; };
+    void setMaxConcurrentDownloads(int);
+    qint64 minimumFreeSpace() const { return m_minimumFreeSpace; };
+    void setMinimumFreeSpace(qint64);
+    int activeCount() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex&, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+public Q_SLOTS:
+    bool setDestination(int index, const QString& path);
+    void cancel(int index);
+    void remove(int index);
+    void clearFinished();
+
+Q_SIGNALS:
+    void downloadDirectoryChanged();
+    void maxConcurrentDownloadsChanged();
+    void minimumFreeSpaceChanged();
+    void countChanged();
+    void activeCountChanged();
+    void downloadAdded(int index, const QString& suggestedFileName);
+    void downloadFinished(int index);
+    void downloadFailed(int index, const QString& errorString);
+
+private:
+    struct Download {
+        GRefPtr<WebKitDownload> download;
+        QUrl url;
+        QString destination;
+        QString mimeType;
+        State state { Queued };
+        bool destinationPending { false };
+        qint64 receivedBytes { 0 };
+        qint64 totalBytes { -1 };
+        qint64 sampledBytes { 0 };
+        qint64 checkedBytes { 0 };
+        qreal throughput { 0 };
+        QString errorString;
+    };
+
+    int indexOf(WebKitDownload*) const;
+    void setState(int index, State);
+    void disconnectDownload(WebKitDownload*);
+    void startQueuedDownloads();
+    bool hasFreeSpace(const Download&) const;
+    QString uniqueDestination(const QString& suggestedFileName) const;
+    void sampleThroughput();
+
+    static void downloadStartedCallback(WebKitNetworkSession*, WebKitDownload*, WPEQtDownloadModel*);
+    static gboolean decideDestinationCallback(WebKitDownload*, const gchar* suggestedFileName, WPEQtDownloadModel*);
+    static void receivedDataCallback(WebKitDownload*, guint64 dataLength, WPEQtDownloadModel*);
+    static void finishedCallback(WebKitDownload*, WPEQtDownloadModel*);
+    static void failedCallback(WebKitDownload*, GError*, WPEQtDownloadModel*);
+
+    std::vector<Download> m_downloads;
+    std::vector<GRefPtr<WebKitNetworkSession>> m_sessions;
+    QString m_downloadDirectory;
+    int m_maxConcurrentDownloads { 2 };
+    qint64 m_minimumFreeSpace { 64 * 1024 * 1024 };
+    QTimer m_sampleTimer;
+    QElapsedTimer m_sinceLastSample;
+};
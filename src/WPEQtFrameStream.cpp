@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtFrameStream.h"
+
+#include <algorithm>
+#include <chrono>
+
+static qint64 monotonicTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+WPEQtViewFrame::WPEQtViewFrame(const QSize& size, EGLImageKHR eglImage, std::shared_ptr<void>&& lease)
+    : m_type(Type::EGLImage)
+    , m_size(size)
+    , m_timestamp(monotonicTimestamp())
+    , m_eglImage(eglImage)
+    , m_lease(std::move(lease))
+{
+}
+
+WPEQtViewFrame::WPEQtViewFrame(QImage&& image)
+    : m_type(Type::Image)
+    , m_size(image.size())
+    , m_timestamp(monotonicTimestamp())
+    , m_image(std::move(image))
+{
+}
+
+/*!
+  \qmltype WPEFrameStream
+  \instantiates WPEQtFrameStream
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief Streams the frames exported by a \l WPEView.
+
+  WPEFrameStream delivers every frame the web process exports for \l view,
+  without re-compositing the Qt scene. Frames are consumed from C++ with
+  WPEQtFrameStream::takeFrame(), typically in response to \l frameAvailable().
+
+  In \c WPEFrameStream.EGLImageMode the frames reference the exported
+  EGLImage directly; the image stays locked for as long as the frame is
+  referenced, but is destroyed along with the web view of \l view, so
+  consumers must drop their frames when the view goes away. Frames can be
+  dropped on any thread, the image is handed back to the web process on
+  the GUI thread. In \c WPEFrameStream.ReadbackMode the frames carry a CPU
+  copy read back asynchronously by the view's renderer, optionally
+  downscaled to \l frameSize.
+
+  At most \l queueSize frames are queued; further frames are dropped until
+  the consumer catches up, and counted in \l droppedFrames.
+*/
+WPEQtFrameStream::WPEQtFrameStream(QObject* parent)
+    : QObject(parent)
+{
+}
+
+WPEQtFrameStream::~WPEQtFrameStream()
+{
+    if (m_view)
+        m_view->m_frameStreams.removeAll(this);
+}
+
+/*!
+  \qmlproperty WPEView WPEFrameStream::view
+
+  The view whose frames are streamed.
+*/
+void WPEQtFrameStream::setView(WPEQtView* view)
+{
+    if (view == m_view)
+        return;
+
+    if (m_view)
+        m_view->m_frameStreams.removeAll(this);
+    m_view = view;
+    if (m_view)
+        m_view->m_frameStreams.append(this);
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.clear();
+    }
+    Q_EMIT viewChanged();
+}
+
+/*!
+  \qmlproperty bool WPEFrameStream::active
+
+  Frames are only captured while the stream is active. The default value is \c true.
+*/
+void WPEQtFrameStream::setActive(bool active)
+{
+    if (active == m_active)
+        return;
+
+    m_active = active;
+    if (!m_active) {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.clear();
+    }
+    Q_EMIT activeChanged();
+}
+
+/*!
+  \qmlproperty enumeration WPEFrameStream::mode
+
+  \value WPEFrameStream.EGLImageMode Frames reference the exported EGLImage (default).
+  \value WPEFrameStream.ReadbackMode Frames carry a CPU copy of the content.
+*/
+void WPEQtFrameStream::setMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+
+    m_mode = mode;
+    Q_EMIT modeChanged();
+}
+
+/*!
+  \qmlproperty real WPEFrameStream::maxFrameRate
+
+  The maximum number of frames per second captured. Frames exported more
+  often are skipped. The default value, \c 0, does not limit the rate.
+*/
+void WPEQtFrameStream::setMaxFrameRate(qreal maxFrameRate)
+{
+    maxFrameRate = std::max<qreal>(maxFrameRate, 0);
+    if (qFuzzyCompare(maxFrameRate, m_maxFrameRate))
+        return;
+
+    m_maxFrameRate = maxFrameRate;
+    Q_EMIT maxFrameRateChanged();
+}
+
+/*!
+  \qmlproperty int WPEFrameStream::queueSize
+
+  The maximum number of frames waiting to be consumed. The default value is \c 3.
+*/
+void WPEQtFrameStream::setQueueSize(int queueSize)
+{
+    queueSize = std::max(queueSize, 1);
+    if (queueSize == m_queueSize)
+        return;
+
+    m_queueSize = queueSize;
+    Q_EMIT queueSizeChanged();
+}
+
+/*!
+  \qmlproperty size WPEFrameStream::frameSize
+
+  The size read back frames are downscaled to fit within. Only used in
+  \c WPEFrameStream.ReadbackMode; by default frames have the full size.
+*/
+void WPEQtFrameStream::setFrameSize(const QSize& frameSize)
+{
+    if (frameSize == m_frameSize)
+        return;
+
+    m_frameSize = frameSize;
+    Q_EMIT frameSizeChanged();
+}
+
+WPEQtViewFrameRef WPEQtFrameStream::takeFrame()
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (m_queue.empty())
+        return nullptr;
+
+    WPEQtViewFrameRef frame = std::move(m_queue.front());
+    m_queue.pop_front();
+    return frame;
+}
+
+void WPEQtFrameStream::offerFrame(WPEQtViewBackend& backend, struct wpe_fdo_egl_exported_image* image)
+{
+    if (!m_active)
+        return;
+
+    if (m_maxFrameRate > 0 && m_lastFrameTimer.isValid() && m_lastFrameTimer.elapsed() < 1000 / m_maxFrameRate)
+        return;
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (static_cast<int>(m_queue.size()) + m_readbacksInFlight >= m_queueSize) {
+            locker.unlock();
+            dropFrame();
+            return;
+        }
+    }
+    m_lastFrameTimer.start();
+
+    if (m_mode == EGLImageMode) {
+        enqueueFrame(backend.leaseFrame(image));
+        return;
+    }
+
+    ++m_readbacksInFlight;
+    QPointer<WPEQtFrameStream> stream(this);
+    backend.requestSnapshot(m_frameSize, [stream](const QImage& image) {
+        if (!stream)
+            return;
+
+        // Every request completes, with a null image when it was cancelled.
+        --stream->m_readbacksInFlight;
+        if (image.isNull() || !stream->m_active)
+            return;
+
+        QImage frameImage(image);
+        stream->enqueueFrame(std::make_shared<const WPEQtViewFrame>(std::move(frameImage)));
+    });
+}
+
+void WPEQtFrameStream::enqueueFrame(WPEQtViewFrameRef&& frame)
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.push_back(std::move(frame));
+    }
+    ++m_deliveredFrames;
+    Q_EMIT statisticsChanged();
+    Q_EMIT frameAvailable();
+}
+
+void WPEQtFrameStream::dropFrame()
+{
+    ++m_droppedFrames;
+    Q_EMIT statisticsChanged();
+}
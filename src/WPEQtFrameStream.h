@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "WPEQtViewBackend.h"
+#include "WPEQtView.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <deque>
+#include <memory>
+
+class WPEQtViewFrame {
+public:
+    enum class Type {
+        EGLImage,
+        Image
+    };
+
+    WPEQtViewFrame(const QSize&, EGLImageKHR, std::shared_ptr<void>&& lease);
+    explicit WPEQtViewFrame(QImage&&);
+
+    Type type() const { return m_type; };
+    QSize size() const { return m_size; };
+    qint64 timestamp() const { return m_timestamp; };
+
+    // Only valid for EGLImage frames, for as long as the frame is referenced
+    // and the web view of the stream exists: the exported images are owned
+    // by the view backend and destroyed along with it.
+    EGLImageKHR eglImage() const { return m_eglImage; };
+    // Only valid for Image frames.
+    const QImage& image() const { return m_image; };
+
+private:
+    Type m_type;
+    QSize m_size;
+    qint64 m_timestamp { 0 };
+    EGLImageKHR m_eglImage { EGL_NO_IMAGE_KHR };
+    QImage m_image;
+    std::shared_ptr<void> m_lease;
+};
+
+using WPEQtViewFrameRef = std::shared_ptr<const WPEQtViewFrame>;
+
+class WPEQtFrameStream : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtFrameStream)
+    Q_PROPERTY(WPEQtView* view READ view WRITE setView NOTIFY viewChanged)
+    Q_PROPERTY(bool active READ isActive WRITE setActive NOTIFY activeChanged)
+    Q_PROPERTY(Mode mode READ mode WRITE setMode NOTIFY modeChanged)
+    Q_PROPERTY(qreal maxFrameRate READ maxFrameRate WRITE setMaxFrameRate NOTIFY maxFrameRateChanged)
+    Q_PROPERTY(int queueSize READ queueSize WRITE setQueueSize NOTIFY queueSizeChanged)
+    Q_PROPERTY(QSize frameSize READ frameSize WRITE setFrameSize NOTIFY frameSizeChanged)
+    Q_PROPERTY(int deliveredFrames READ deliveredFrames NOTIFY statisticsChanged)
+    Q_PROPERTY(int droppedFrames READ droppedFrames NOTIFY statisticsChanged)
+    Q_ENUMS(Mode)
+
+public:
+    enum Mode {
+        EGLImageMode,
+        ReadbackMode
+    };
+
+    WPEQtFrameStream(QObject* parent = nullptr);
+    ~WPEQtFrameStream();
+
+    WPEQtView* view() const { return m_view; };
+    void setView(WPEQtView*);
+    bool isActive() const { return m_active; };
+    void setActive(bool);
+    Mode mode() const { return m_mode; };
+    void setMode(Mode);
+    qreal maxFrameRate() const { return m_maxFrameRate; };
+    void setMaxFrameRate(qreal);
+    int queueSize() const { return m_queueSize; };
+    void setQueueSize(int);
+    QSize frameSize() const { return m_frameSize; };
+    void setFrameSize(const QSize&);
+    int deliveredFrames() const { return m_deliveredFrames; };
+    int droppedFrames() const { return m_droppedFrames; };
+
+    // Thread-safe, returns a null reference when the queue is empty.
+    WPEQtViewFrameRef takeFrame();
+
+    void offerFrame(WPEQtViewBackend&, struct wpe_fdo_egl_exported_image*);
+
+Q_SIGNALS:
+    void viewChanged();
+    void activeChanged();
+    void modeChanged();
+    void maxFrameRateChanged();
+    void queueSizeChanged();
+    void frameSizeChanged();
+    void statisticsChanged();
+    void frameAvailable();
+
+private:
+    void enqueueFrame(WPEQtViewFrameRef&&);
+    void dropFrame();
+
+    QPointer<WPEQtView> m_view;
+    bool m_active { true };
+    Mode m_mode { EGLImageMode };
+    qreal m_maxFrameRate { 0 };
+    int m_queueSize { 3 };
+    QSize m_frameSize;
+    int m_deliveredFrames { 0 };
+    int m_droppedFrames { 0 };
+    int m_readbacksInFlight { 0 };
+    QElapsedTimer m_lastFrameTimer;
+
+    mutable QMutex m_queueMutex;
+    std::deque<WPEQtViewFrameRef> m_queue;
+};
@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtGeolocation.h"
+
+#include <QCoreApplication>
+#include <QGeoCoordinate>
+#include <QtMath>
+#include <algorithm>
+
+// Accuracy reported to pages when the source does not provide one, in meters.
+static const double unknownAccuracy = 1000;
+
+WPEQtLocalPositionSource::WPEQtLocalPositionSource(QObject* parent)
+    : QGeoPositionInfoSource(parent)
+{
+}
+
+void WPEQtLocalPositionSource::pushPosition(const QGeoPositionInfo& info)
+{
+    m_lastPosition = info;
+    if (m_active || m_updateRequested) {
+        m_updateRequested = false;
+        Q_EMIT positionUpdated(info);
+    }
+}
+
+QGeoPositionInfo WPEQtLocalPositionSource::lastKnownPosition(bool) const
+{
+    return m_lastPosition;
+}
+
+void WPEQtLocalPositionSource::startUpdates()
+{
+    m_active = true;
+    if (m_lastPosition.isValid())
+        Q_EMIT positionUpdated(m_lastPosition);
+}
+
+void WPEQtLocalPositionSource::stopUpdates()
+{
+    m_active = false;
+}
+
+void WPEQtLocalPositionSource::requestUpdate(int)
+{
+    if (m_lastPosition.isValid())
+        Q_EMIT positionUpdated(m_lastPosition);
+    else
+        m_updateRequested = true;
+}
+
+/*!
+  \qmltype WPEGeolocation
+  \inqmlmodule org.wpewebkit.qtwpe
+  \brief Configures the position source shared by all the web views.
+
+  WPEGeolocation is a singleton providing the positions requested through the
+  Geolocation API by the pages of all the \l {WPEView}s. A single position
+  source is started when the first page starts watching the position, and
+  stopped when the last one stops. Updates are throttled so that pages are
+  sent at most one position per \l minimumUpdateInterval.
+
+  \badcode
+  Component.onCompleted: {
+      WPEGeolocation.minimumUpdateInterval = 1000
+  }
+  \endcode
+*/
+WPEQtGeolocation* WPEQtGeolocation::singleton()
+{
+    static QPointer<WPEQtGeolocation> geolocation;
+    if (!geolocation)
+        geolocation = new WPEQtGeolocation(QCoreApplication::instance());
+    return geolocation;
+}
+
+WPEQtGeolocation::WPEQtGeolocation(QObject* parent)
+    : QObject(parent)
+    , m_localSource(new WPEQtLocalPositionSource(this))
+{
+    m_deliveryTimer.setSingleShot(true);
+    connect(&m_deliveryTimer, &QTimer::timeout, this, &WPEQtGeolocation::deliverPosition);
+}
+
+WPEQtGeolocation::~WPEQtGeolocation()
+{
+    for (auto& entry : m_managers) {
+        g_signal_handlers_disconnect_by_data(entry.manager, this);
+        g_object_weak_unref(G_OBJECT(entry.manager), managerDestroyedCallback, this);
+    }
+}
+
+/*!
+  \qmlproperty string WPEGeolocation::sourceName
+
+  The name of the Qt Positioning plugin providing the positions, or
+  \c "local" to use the positions given to \l pushPosition(). When empty,
+  the default source of the platform is used.
+
+  Changing the source while it is active restarts it.
+*/
+void WPEQtGeolocation::setSourceName(const QString& sourceName)
+{
+    if (sourceName == m_sourceName)
+        return;
+
+    m_sourceName = sourceName;
+    if (m_refCount) {
+        destroySource();
+        createSource();
+    }
+    Q_EMIT sourceNameChanged();
+}
+
+/*!
+  \qmlproperty int WPEGeolocation::minimumUpdateInterval
+
+  The minimum interval between two positions sent to the pages, in
+  milliseconds. Positions received within the interval replace each other,
+  and the latest one is sent when it elapses.
+
+  The default value is \c 1000. A value of \c 0 sends every update.
+*/
+void WPEQtGeolocation::setMinimumUpdateInterval(int interval)
+{
+    interval = std::max(interval, 0);
+    if (interval == m_minimumUpdateInterval)
+        return;
+
+    m_minimumUpdateInterval = interval;
+    if (m_source)
+        m_source->setUpdateInterval(m_minimumUpdateInterval);
+    Q_EMIT minimumUpdateIntervalChanged();
+}
+
+/*!
+  \qmlproperty bool WPEGeolocation::active
+  \readonly
+
+  Whether the position source is running.
+*/
+
+/*!
+  \qmlmethod void WPEGeolocation::pushPosition(real latitude, real longitude, real accuracy, real altitude, real speed, real heading)
+
+  Feeds a position to the \c "local" source. The \a altitude, \a speed and
+  \a heading are optional. The position is kept and sent to pages that start
+  watching the position later.
+
+  \sa sourceName
+*/
+void WPEQtGeolocation::pushPosition(double latitude, double longitude, double accuracy, double altitude, double speed, double heading)
+{
+    QGeoPositionInfo info(QGeoCoordinate(latitude, longitude, altitude), QDateTime::currentDateTimeUtc());
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
+    if (!qIsNaN(speed))
+        info.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
+    if (!qIsNaN(heading))
+        info.setAttribute(QGeoPositionInfo::Direction, heading);
+    m_localSource->pushPosition(info);
+}
+
+WPEQtGeolocation::Manager* WPEQtGeolocation::findManager(WebKitGeolocationManager* manager)
+{
+    auto it = std::find_if(m_managers.begin(), m_managers.end(), [manager](const Manager& entry) {
+        return entry.manager == manager;
+    });
+    return it != m_managers.end() ? &*it : nullptr;
+}
+
+// Geolocation managers belong to web contexts, which are shared by all the
+// views of a profile, so each of them is only connected once. They are not
+// kept alive: the entry goes away with the web context of the profile.
+void WPEQtGeolocation::addManager(WebKitGeolocationManager* manager)
+{
+    if (!manager || findManager(manager))
+        return;
+
+    m_managers.push_back({ manager, false });
+    g_signal_connect(manager, "start", G_CALLBACK(startCallback), this);
+    g_signal_connect(manager, "stop", G_CALLBACK(stopCallback), this);
+    g_object_weak_ref(G_OBJECT(manager), managerDestroyedCallback, this);
+}
+
+void WPEQtGeolocation::managerDestroyedCallback(gpointer userData, GObject* manager)
+{
+    auto* geolocation = static_cast<WPEQtGeolocation*>(userData);
+    auto* entry = geolocation->findManager(reinterpret_cast<WebKitGeolocationManager*>(manager));
+    if (!entry)
+        return;
+
+    const bool started = entry->started;
+    geolocation->m_managers.erase(geolocation->m_managers.begin() + (entry - geolocation->m_managers.data()));
+    if (started)
+        geolocation->release();
+}
+
+// Returns false when no position source is available, in which case the
+// reference is not kept so that the next request tries again.
+bool WPEQtGeolocation::acquire()
+{
+    ++m_refCount;
+    if (!m_source)
+        createSource();
+    if (m_source)
+        return true;
+
+    --m_refCount;
+    return false;
+}
+
+void WPEQtGeolocation::release()
+{
+    if (!m_refCount || --m_refCount)
+        return;
+
+    destroySource();
+}
+
+void WPEQtGeolocation::createSource()
+{
+    QGeoPositionInfoSource* source;
+    if (m_sourceName == QLatin1String("local"))
+        source = m_localSource;
+    else if (m_sourceName.isEmpty())
+        source = QGeoPositionInfoSource::createDefaultSource(this);
+    else
+        source = QGeoPositionInfoSource::createSource(m_sourceName, this);
+
+    if (!source) {
+        qWarning("WPEGeolocation: no position source available");
+        sourceFailed(QGeoPositionInfoSource::UnknownSourceError);
+        return;
+    }
+
+    m_source = source;
+    connect(source, &QGeoPositionInfoSource::positionUpdated, this, &WPEQtGeolocation::positionUpdated);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    connect(source, &QGeoPositionInfoSource::errorOccurred, this, &WPEQtGeolocation::sourceFailed);
+#else
+    connect(source, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error), this, &WPEQtGeolocation::sourceFailed);
+#endif
+    source->setUpdateInterval(m_minimumUpdateInterval);
+    source->startUpdates();
+    Q_EMIT activeChanged();
+}
+
+void WPEQtGeolocation::destroySource()
+{
+    m_deliveryTimer.stop();
+    m_pendingPosition = QGeoPositionInfo();
+    m_sinceLastDelivery.invalidate();
+    if (!m_source)
+        return;
+
+    m_source->stopUpdates();
+    disconnect(m_source, nullptr, this, nullptr);
+    if (m_source != m_localSource)
+        delete m_source;
+    m_source = nullptr;
+    Q_EMIT activeChanged();
+}
+
+void WPEQtGeolocation::positionUpdated(const QGeoPositionInfo& info)
+{
+    m_pendingPosition = info;
+    if (m_deliveryTimer.isActive())
+        return;
+
+    const qint64 elapsed = m_sinceLastDelivery.isValid() ? m_sinceLastDelivery.elapsed() : m_minimumUpdateInterval;
+    if (elapsed >= m_minimumUpdateInterval)
+        deliverPosition();
+    else
+        m_deliveryTimer.start(m_minimumUpdateInterval - elapsed);
+}
+
+void WPEQtGeolocation::deliverPosition()
+{
+    if (!m_pendingPosition.isValid())
+        return;
+
+    const QGeoPositionInfo info = std::exchange(m_pendingPosition, QGeoPositionInfo());
+    const QGeoCoordinate coordinate = info.coordinate();
+    const double accuracy = info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy) ? info.attribute(QGeoPositionInfo::HorizontalAccuracy) : unknownAccuracy;
+
+    WebKitGeolocationPosition* position = webkit_geolocation_position_new(coordinate.latitude(), coordinate.longitude(), accuracy);
+    webkit_geolocation_position_set_timestamp(position, info.timestamp().toMSecsSinceEpoch() / 1000);
+    if (coordinate.type() == QGeoCoordinate::Coordinate3D) {
+        webkit_geolocation_position_set_altitude(position, coordinate.altitude());
+        if (info.hasAttribute(QGeoPositionInfo::VerticalAccuracy))
+            webkit_geolocation_position_set_altitude_accuracy(position, info.attribute(QGeoPositionInfo::VerticalAccuracy));
+    }
+    if (info.hasAttribute(QGeoPositionInfo::GroundSpeed))
+        webkit_geolocation_position_set_speed(position, info.attribute(QGeoPositionInfo::GroundSpeed));
+    if (info.hasAttribute(QGeoPositionInfo::Direction))
+        webkit_geolocation_position_set_heading(position, info.attribute(QGeoPositionInfo::Direction));
+
+    for (auto& manager : m_managers) {
+        if (manager.started)
+            webkit_geolocation_manager_update_position(manager.manager, position);
+    }
+    webkit_geolocation_position_free(position);
+    m_sinceLastDelivery.start();
+}
+
+void WPEQtGeolocation::sourceFailed(QGeoPositionInfoSource::Error error)
+{
+    if (error == QGeoPositionInfoSource::NoError)
+        return;
+
+    const char* message = error == QGeoPositionInfoSource::AccessError ? "Position access denied" : "Position unavailable";
+    for (auto& manager : m_managers) {
+        if (manager.started)
+            webkit_geolocation_manager_failed(manager.manager, message);
+    }
+}
+
+gboolean WPEQtGeolocation::startCallback(WebKitGeolocationManager* manager, WPEQtGeolocation* geolocation)
+{
+    auto* entry = geolocation->findManager(manager);
+    if (!entry)
+        return FALSE;
+
+    if (!entry->started) {
+        // Marked first, so that a failing source reports the error to it.
+        entry->started = true;
+        if (!geolocation->acquire()) {
+            entry->started = false;
+            return TRUE;
+        }
+    }
+
+    // Pages starting to watch the position get the last one as soon as the
+    // throttling allows.
+    if (geolocation->m_source && geolocation->m_sinceLastDelivery.isValid()) {
+        QGeoPositionInfo last = geolocation->m_source->lastKnownPosition();
+        if (last.isValid() && !geolocation->m_pendingPosition.isValid())
+            geolocation->positionUpdated(last);
+    }
+    return TRUE;
+}
+
+void WPEQtGeolocation::stopCallback(WebKitGeolocationManager* manager, WPEQtGeolocation* geolocation)
+{
+    auto* entry = geolocation->findManager(manager);
+    if (!entry || !entry->started)
+        return;
+
+    entry->started = false;
+    geolocation->release();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QElapsedTimer>
+#include <QGeoPositionInfo>
+#include <QGeoPositionInfoSource>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <qnumeric.h>
+#include <vector>
+#include <wpe/webkit.h>
+
+// Position source fed by the application, used as a stand-in for the
+// platform positioning backends by tests, simulators and devices that
+// receive their positions by other means.
+class WPEQtLocalPositionSource : public QGeoPositionInfoSource {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtLocalPositionSource)
+
+public:
+    explicit WPEQtLocalPositionSource(QObject* parent = nullptr);
+
+    void pushPosition(const QGeoPositionInfo&);
+
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; };
+    int minimumUpdateInterval() const override { return 0; };
+    Error error() const override { return NoError; };
+
+public Q_SLOTS:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+private:
+    QGeoPositionInfo m_lastPosition;
+    bool m_active { false };
+    bool m_updateRequested { false };
+};
+
+class WPEQtGeolocation : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtGeolocation)
+    Q_PROPERTY(QString sourceName READ sourceName WRITE setSourceName NOTIFY sourceNameChanged)
+    Q_PROPERTY(int minimumUpdateInterval READ minimumUpdateInterval WRITE setMinimumUpdateInterval NOTIFY minimumUpdateIntervalChanged)
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged)
+
+public:
+    static WPEQtGeolocation* singleton();
+
+    QString sourceName() const { return m_sourceName; };
+    void setSourceName(const QString&);
+    int minimumUpdateInterval() const { return m_minimumUpdateInterval; };
+    void setMinimumUpdateInterval(int);
+    bool isActive() const { return m_source; };
+
+    void addManager(WebKitGeolocationManager*);
+
+    bool acquire();
+    void release();
+
+public Q_SLOTS:
+    void pushPosition(double latitude, double longitude, double accuracy, double altitude = qQNaN(), double speed = qQNaN(), double heading = qQNaN());
+
+Q_SIGNALS:
+    void sourceNameChanged();
+    void minimumUpdateIntervalChanged();
+    void activeChanged();
+
+private:
+    explicit WPEQtGeolocation(QObject* parent);
+    ~WPEQtGeolocation();
+
+    struct Manager {
+        WebKitGeolocationManager* manager;
+        bool started { false };
+    };
+    Manager* findManager(WebKitGeolocationManager*);
+
+    void createSource();
+    void destroySource();
+    void positionUpdated(const QGeoPositionInfo&);
+    void sourceFailed(QGeoPositionInfoSource::Error);
+    void deliverPosition();
+
+    static gboolean startCallback(WebKitGeolocationManager*, WPEQtGeolocation*);
+    static void stopCallback(WebKitGeolocationManager*, WPEQtGeolocation*);
+    static void managerDestroyedCallback(gpointer, GObject*);
+
+    QString m_sourceName;
+    int m_minimumUpdateInterval { 1000 };
+    unsigned m_refCount { 0 };
+    std::vector<Manager> m_managers;
+    WPEQtLocalPositionSource* m_localSource;
+    QPointer<QGeoPositionInfoSource> m_source;
+    QGeoPositionInfo m_pendingPosition;
+    QElapsedTimer m_sinceLastDelivery;
+    QTimer m_deliveryTimer;
+};
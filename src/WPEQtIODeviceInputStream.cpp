@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "WPEQtIODeviceInputStream.h"
+
+#include <QIODevice>
+#include <QThread>
+#include <memory>
+
+namespace {
+
+// Performs the reads on the thread of the device, which is not thread-safe
+// and is usually driven by the event loop of the GUI thread.
+class IODeviceReader final : public QObject {
+public:
+    explicit IODeviceReader(QIODevice* device)
+        : m_device(device)
+    {
+        moveToThread(device->thread());
+        connect(device, &QIODevice::readyRead, this, &IODeviceReader::readPending);
+        connect(device, &QIODevice::readChannelFinished, this, &IODeviceReader::finish);
+        connect(device, &QIODevice::aboutToClose, this, &IODeviceReader::finish);
+    }
+
+    QIODevice* device() const { return m_device.get(); }
+
+    // Returns false when a sequential device has no data yet but more may come.
+    bool tryRead(void* buffer, gsize count, gssize& bytesRead, GError** error)
+    {
+        if (!m_device->isOpen()) {
+            bytesRead = 0;
+            return true;
+        }
+
+        bytesRead = m_device->read(static_cast<char*>(buffer), count);
+        if (bytesRead < 0) {
+            g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, qPrintable(m_device->errorString()));
+            return true;
+        }
+
+        // A sequential device reads nothing until data arrives, its end is
+        // only reached once it reports that no more data will come.
+        return bytesRead || (m_device->atEnd() && (!m_device->isSequential() || m_finished));
+    }
+
+    void read(GTask* task, void* buffer, gsize count)
+    {
+        m_task = task;
+        m_buffer = buffer;
+        m_count = count;
+        if (GCancellable* cancellable = g_task_get_cancellable(task)) {
+            m_cancelledHandler = g_cancellable_connect(cancellable, G_CALLBACK(+[](GCancellable*, IODeviceReader* reader) {
+                QMetaObject::invokeMethod(reader, [reader] {
+                    reader->readPending();
+                }, Qt::QueuedConnection);
+            }), this, nullptr);
+        }
+        readPending();
+    }
+
+private:
+    void finish()
+    {
+        m_finished = true;
+        readPending();
+    }
+
+    void readPending()
+    {
+        if (!m_task)
+            return;
+
+        if (!g_task_return_error_if_cancelled(m_task)) {
+            GError* error = nullptr;
+            gssize bytesRead = 0;
+            if (!tryRead(m_buffer, m_count, bytesRead, &error))
+                return;
+            if (error)
+                g_task_return_error(m_task, error);
+            else
+                g_task_return_int(m_task, bytesRead);
+        }
+
+        if (m_cancelledHandler)
+            g_cancellable_disconnect(g_task_get_cancellable(m_task), m_cancelledHandler);
+        m_cancelledHandler = 0;
+        g_object_unref(m_task);
+        m_task = nullptr;
+    }
+
+    std::unique_ptr<QIODevice> m_device;
+    bool m_finished { false };
+    GTask* m_task { nullptr };
+    void* m_buffer { nullptr };
+    gsize m_count { 0 };
+    gulong m_cancelledHandler { 0 };
+};
+
+}
+
+struct _WPEQtIODeviceInputStream {
+    GInputStream parent_instance;
+    IODeviceReader *reader;
+};
+
+G_DEFINE_TYPE(WPEQtIODeviceInputStream, wpeqt_io_device_input_stream, G_TYPE_INPUT_STREAM)
+
+static void wpeqt_io_device_input_stream_finalize(GObject *object)
+{
+    WPEQtIODeviceInputStream *stream = WPEQT_IO_DEVICE_INPUT_STREAM(object);
+
+    // The device is deleted on its own thread.
+    stream->reader->deleteLater();
+
+    G_OBJECT_CLASS(wpeqt_io_device_input_stream_parent_class)->finalize(object);
+}
+
+static void wpeqt_io_device_input_stream_read_async(GInputStream *input_stream, void *buffer, gsize count, int priority, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    WPEQtIODeviceInputStream *stream = WPEQT_IO_DEVICE_INPUT_STREAM(input_stream);
+
+    GTask *task = g_task_new(input_stream, cancellable, callback, user_data);
+    g_task_set_priority(task, priority);
+
+    IODeviceReader *reader = stream->reader;
+    QMetaObject::invokeMethod(reader, [reader, task, buffer, count] {
+        reader->read(task, buffer, count);
+    }, Qt::QueuedConnection);
+}
+
+static gssize wpeqt_io_device_input_stream_read_finish(GInputStream *, GAsyncResult *result, GError **error)
+{
+    return g_task_propagate_int(G_TASK(result), error);
+}
+
+static gssize wpeqt_io_device_input_stream_read(GInputStream *input_stream, void *buffer, gsize count, GCancellable *cancellable, GError **error)
+{
+    WPEQtIODeviceInputStream *stream = WPEQT_IO_DEVICE_INPUT_STREAM(input_stream);
+
+    if (g_cancellable_set_error_if_cancelled(cancellable, error))
+        return -1;
+
+    // The thread of the device cannot wait for its own event loop.
+    if (stream->reader->thread() == QThread::currentThread()) {
+        gssize bytesRead = 0;
+        if (!stream->reader->tryRead(buffer, count, bytesRead, error)) {
+            g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK, "No data available yet");
+            return -1;
+        }
+        return bytesRead;
+    }
+
+    // Other threads wait for an asynchronous read, completed in a private main context.
+    GMainContext *context = g_main_context_new();
+    g_main_context_push_thread_default(context);
+    GAsyncResult *result = nullptr;
+    wpeqt_io_device_input_stream_read_async(input_stream, buffer, count, G_PRIORITY_DEFAULT, cancellable, [](GObject *, GAsyncResult *asyncResult, gpointer userData) {
+        *static_cast<GAsyncResult **>(userData) = G_ASYNC_RESULT(g_object_ref(asyncResult));
+    }, &result);
+    while (!result)
+        g_main_context_iteration(context, TRUE);
+    g_main_context_pop_thread_default(context);
+    g_main_context_unref(context);
+
+    gssize bytesRead = wpeqt_io_device_input_stream_read_finish(input_stream, result, error);
+    g_object_unref(result);
+    return bytesRead;
+}
+
+static gboolean wpeqt_io_device_input_stream_close(GInputStream *input_stream, GCancellable *, GError **)
+{
+    WPEQtIODeviceInputStream *stream = WPEQT_IO_DEVICE_INPUT_STREAM(input_stream);
+
+    IODeviceReader *reader = stream->reader;
+    QMetaObject::invokeMethod(reader, [reader] {
+        reader->device()->close();
+    }, Qt::QueuedConnection);
+    return TRUE;
+}
+
+static void wpeqt_io_device_input_stream_class_init(WPEQtIODeviceInputStreamClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    gobject_class->finalize = wpeqt_io_device_input_stream_finalize;
+
+    GInputStreamClass *input_stream_class = G_INPUT_STREAM_CLASS(klass);
+    input_stream_class->read_fn = wpeqt_io_device_input_stream_read;
+    input_stream_class->read_async = wpeqt_io_device_input_stream_read_async;
+    input_stream_class->read_finish = wpeqt_io_device_input_stream_read_finish;
+    input_stream_class->close_fn = wpeqt_io_device_input_stream_close;
+}
+
+static void wpeqt_io_device_input_stream_init(WPEQtIODeviceInputStream *)
+{
+}
+
+GInputStream *wpeqt_io_device_input_stream_new(QIODevice *device)
+{
+    WPEQtIODeviceInputStream *stream = WPEQT_IO_DEVICE_INPUT_STREAM(g_object_new(WPEQT_TYPE_IO_DEVICE_INPUT_STREAM, NULL));
+    stream->reader = new IODeviceReader(device);
+
+    return G_INPUT_STREAM(stream);
+}
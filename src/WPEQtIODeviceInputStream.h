@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <gio/gio.h>
+
+class QIODevice;
+
+G_BEGIN_DECLS
+
+#define WPEQT_TYPE_IO_DEVICE_INPUT_STREAM (wpeqt_io_device_input_stream_get_type())
+
+G_DECLARE_FINAL_TYPE(WPEQtIODeviceInputStream, wpeqt_io_device_input_stream, WPEQT, IO_DEVICE_INPUT_STREAM, GInputStream)
+
+// Takes ownership of the device, which must already be open for reading and
+// must not be used elsewhere. Reads are performed on the thread of the device,
+// which must run a Qt event loop, and the device is deleted there.
+GInputStream *wpeqt_io_device_input_stream_new(QIODevice *device);
+
+G_END_DECLS
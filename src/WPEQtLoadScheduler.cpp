@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtLoadScheduler.h"
+
+#include "WPEQtView.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <algorithm>
+
+/*!
+  \qmltype WPELoadScheduler
+  \inqmlmodule org.wpewebkit.qtwpe
+  \brief Admits the initial page loads of the views one batch at a time.
+
+  WPELoadScheduler is a singleton deciding when the views start loading their
+  initial content, that is the \l {WPEView::url}{url} or HTML set before the
+  web view was created, or the state passed to
+  \l {WPEView::restoreState()}{restoreState()}. When an application creates
+  many views at once, loading all of them together competes for the CPU and
+  the network, and the view the user looks at finishes last.
+
+  With \l maxConcurrentLoads set, at most that many initial loads run at the
+  same time, and the waiting views are admitted by priority: views with the
+  active focus first, then visible views, then hidden ones, see
+  \l {WPEView::priority}{WPEView.priority}. Views waiting with the same
+  priority are admitted in the order they were created. A view that gets the
+  active focus while waiting is admitted right away.
+
+  Navigations requested after the initial load, such as changing the URL
+  later on, are never delayed.
+
+  \badcode
+  Component.onCompleted: {
+      WPELoadScheduler.maxConcurrentLoads = 2
+  }
+  \endcode
+*/
+WPEQtLoadScheduler* WPEQtLoadScheduler::singleton()
+{
+    static QPointer<WPEQtLoadScheduler> scheduler;
+    if (!scheduler)
+        scheduler = new WPEQtLoadScheduler(QCoreApplication::instance());
+    return scheduler;
+}
+
+WPEQtLoadScheduler::WPEQtLoadScheduler(QObject* parent)
+    : QObject(parent)
+{
+}
+
+/*!
+  \qmlproperty int WPELoadScheduler::maxConcurrentLoads
+
+  The maximum number of initial loads running at the same time. The default
+  value, \c 0, starts every load right away.
+*/
+void WPEQtLoadScheduler::setMaxConcurrentLoads(int maxConcurrentLoads)
+{
+    maxConcurrentLoads = std::max(maxConcurrentLoads, 0);
+    if (maxConcurrentLoads == m_maxConcurrentLoads)
+        return;
+
+    m_maxConcurrentLoads = maxConcurrentLoads;
+    Q_EMIT maxConcurrentLoadsChanged();
+    admit();
+}
+
+/*!
+  \qmlproperty int WPELoadScheduler::loadTimeout
+
+  The time in milliseconds after which a load that has not finished yet
+  stops counting towards \l maxConcurrentLoads, so that a slow page does not
+  hold back the other views. The default value is \c 15000.
+*/
+void WPEQtLoadScheduler::setLoadTimeout(int loadTimeout)
+{
+    loadTimeout = std::max(loadTimeout, 0);
+    if (loadTimeout == m_loadTimeout)
+        return;
+
+    m_loadTimeout = loadTimeout;
+    Q_EMIT loadTimeoutChanged();
+}
+
+/*!
+  \qmlproperty int WPELoadScheduler::activeCount
+  \readonly
+
+  The number of admitted loads that have not finished yet.
+*/
+
+/*!
+  \qmlproperty int WPELoadScheduler::pendingCount
+  \readonly
+
+  The number of views waiting for their initial load to be admitted.
+*/
+
+void WPEQtLoadScheduler::schedule(WPEQtView* view)
+{
+    if (isPending(view))
+        return;
+
+    if (hasFreeSlot() && m_pending.isEmpty()) {
+        start(view);
+        return;
+    }
+
+    m_pending.append(view);
+    connect(view, &QQuickItem::activeFocusChanged, this, &WPEQtLoadScheduler::admit);
+    connect(view, &QQuickItem::visibleChanged, this, &WPEQtLoadScheduler::admit);
+    Q_EMIT pendingCountChanged();
+    admit();
+}
+
+bool WPEQtLoadScheduler::isPending(WPEQtView* view) const
+{
+    return std::any_of(m_pending.begin(), m_pending.end(), [view](const QPointer<WPEQtView>& pending) {
+        return pending == view;
+    });
+}
+
+void WPEQtLoadScheduler::finished(WPEQtView* view)
+{
+    auto it = std::find_if(m_active.begin(), m_active.end(), [view](const ActiveLoad& load) {
+        return load.view == view;
+    });
+    if (it != m_active.end())
+        release(it->id);
+}
+
+void WPEQtLoadScheduler::cancel(WPEQtView* view)
+{
+    const int pendingCount = m_pending.size();
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(), [view](const QPointer<WPEQtView>& pending) {
+        return !pending || pending == view;
+    }), m_pending.end());
+    disconnect(view, nullptr, this, nullptr);
+    if (pendingCount != m_pending.size())
+        Q_EMIT pendingCountChanged();
+
+    finished(view);
+}
+
+bool WPEQtLoadScheduler::hasFreeSlot() const
+{
+    return !m_maxConcurrentLoads || m_active.size() < m_maxConcurrentLoads;
+}
+
+void WPEQtLoadScheduler::start(WPEQtView* view)
+{
+    if (!view->loadInitialContent())
+        return;
+
+    const quint64 id = m_nextLoadId++;
+    m_active.append({ view, id });
+    Q_EMIT activeCountChanged();
+    if (m_loadTimeout)
+        QTimer::singleShot(m_loadTimeout, this, [this, id] { release(id); });
+}
+
+void WPEQtLoadScheduler::release(quint64 id)
+{
+    auto it = std::find_if(m_active.begin(), m_active.end(), [id](const ActiveLoad& load) {
+        return load.id == id;
+    });
+    if (it == m_active.end())
+        return;
+
+    m_active.erase(it);
+    Q_EMIT activeCountChanged();
+    admit();
+}
+
+void WPEQtLoadScheduler::admit()
+{
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(), [](const QPointer<WPEQtView>& pending) {
+        return !pending;
+    }), m_pending.end());
+
+    while (!m_pending.isEmpty()) {
+        // The first of the waiting views with the highest priority.
+        auto next = std::min_element(m_pending.begin(), m_pending.end(), [](const QPointer<WPEQtView>& a, const QPointer<WPEQtView>& b) {
+            return a->loadPriority() < b->loadPriority();
+        });
+        if (!hasFreeSlot() && (*next)->loadPriority() != WPEQtView::ForegroundPriority)
+            break;
+
+        WPEQtView* view = *next;
+        m_pending.erase(next);
+        disconnect(view, nullptr, this, nullptr);
+        Q_EMIT pendingCountChanged();
+        start(view);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class WPEQtView;
+
+class WPEQtLoadScheduler : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtLoadScheduler)
+    Q_PROPERTY(int maxConcurrentLoads READ maxConcurrentLoads WRITE setMaxConcurrentLoads NOTIFY maxConcurrentLoadsChanged)
+    Q_PROPERTY(int loadTimeout READ loadTimeout WRITE setLoadTimeout NOTIFY loadTimeoutChanged)
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY activeCountChanged)
+    Q_PROPERTY(int pendingCount READ pendingCount NOTIFY pendingCountChanged)
+
+public:
+    static WPEQtLoadScheduler* singleton();
+
+    int maxConcurrentLoads() const { return m_maxConcurrentLoads; };
+    void setMaxConcurrentLoads(int);
+    int loadTimeout() const { return m_loadTimeout; };
+    void setLoadTimeout(int);
+    int activeCount() const { return m_active.size(); };
+    int pendingCount() const { return m_pending.size(); };
+
+    void schedule(WPEQtView*);
+    bool isPending(WPEQtView*) const;
+    void finished(WPEQtView*);
+    void cancel(WPEQtView*);
+
+Q_SIGNALS:
+    void maxConcurrentLoadsChanged();
+    void loadTimeoutChanged();
+    void activeCountChanged();
+    void pendingCountChanged();
+
+private Q_SLOTS:
+    void admit();
+
+private:
+    explicit WPEQtLoadScheduler(QObject* parent);
+
+    struct ActiveLoad {
+        QPointer<WPEQtView> view;
+        quint64 id;
+    };
+
+    bool hasFreeSlot() const;
+    void start(WPEQtView*);
+    void release(quint64 id);
+
+    int m_maxConcurrentLoads { 0 };
+    int m_loadTimeout { 15000 };
+    quint64 m_nextLoadId { 1 };
+    QVector<QPointer<WPEQtView>> m_pending;
+    QVector<ActiveLoad> m_active;
+};
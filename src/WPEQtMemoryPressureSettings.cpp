@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtMemoryPressureSettings.h"
+
+#include <algorithm>
+
+/*!
+  \qmltype WPEMemoryPressureSettings
+  \instantiates WPEQtMemoryPressureSettings
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief Memory pressure configuration of the web or network processes.
+
+  WebKit processes poll their own memory use and, when it crosses a fraction
+  of the memory limit, release caches. Past the conservative threshold only
+  non-critical memory is released; past the strict threshold everything that
+  can be rebuilt is released. The defaults are tuned for desktop systems and
+  react late on devices with little memory.
+
+  Settings are grouped properties of \l WPEProfile and take effect when the
+  corresponding processes are configured, which happens when the first view
+  using the profile is created. A value of \c 0 keeps the WebKit default.
+
+  \qml
+  WPEProfile {
+      webProcessMemoryPressure.memoryLimit: 300
+      webProcessMemoryPressure.conservativeThreshold: 0.25
+      webProcessMemoryPressure.strictThreshold: 0.4
+      webProcessMemoryPressure.pollInterval: 5
+  }
+  \endqml
+
+  \sa {WPEProfile::webProcessMemoryPressure}, {WPEProfile::networkProcessMemoryPressure}
+*/
+WPEQtMemoryPressureSettings::WPEQtMemoryPressureSettings(const char* name, QObject* parent)
+    : QObject(parent)
+    , m_name(name)
+{
+}
+
+bool WPEQtMemoryPressureSettings::checkNotApplied(const char* property) const
+{
+    if (!m_applied)
+        return true;
+
+    qWarning("WPEProfile: %s.%s cannot be changed once the process has been configured", m_name, property);
+    return false;
+}
+
+bool WPEQtMemoryPressureSettings::isDefault() const
+{
+    return !m_memoryLimit && !m_conservativeThreshold && !m_strictThreshold && !m_killThreshold && !m_pollInterval;
+}
+
+/*!
+  \qmlproperty int WPEMemoryPressureSettings::memoryLimit
+
+  The memory limit of the process in megabytes, which the thresholds are
+  fractions of. The default value, \c 0, lets WebKit derive the limit from the
+  system memory.
+*/
+void WPEQtMemoryPressureSettings::setMemoryLimit(int memoryLimit)
+{
+    memoryLimit = std::max(memoryLimit, 0);
+    if (memoryLimit == m_memoryLimit || !checkNotApplied("memoryLimit"))
+        return;
+
+    m_memoryLimit = memoryLimit;
+    Q_EMIT memoryLimitChanged();
+}
+
+/*!
+  \qmlproperty real WPEMemoryPressureSettings::conservativeThreshold
+
+  The fraction of \l memoryLimit, between \c 0 and \c 1, above which the
+  process starts releasing non-critical memory. It must be lower than
+  \l strictThreshold.
+*/
+void WPEQtMemoryPressureSettings::setConservativeThreshold(qreal threshold)
+{
+    if (threshold < 0 || threshold >= 1) {
+        qWarning("WPEProfile: %s.conservativeThreshold must be between 0 and 1", m_name);
+        return;
+    }
+    if (qFuzzyCompare(threshold + 1, m_conservativeThreshold + 1) || !checkNotApplied("conservativeThreshold"))
+        return;
+
+    m_conservativeThreshold = threshold;
+    Q_EMIT conservativeThresholdChanged();
+}
+
+/*!
+  \qmlproperty real WPEMemoryPressureSettings::strictThreshold
+
+  The fraction of \l memoryLimit, between \c 0 and \c 1, above which the
+  process releases all the memory it can.
+*/
+void WPEQtMemoryPressureSettings::setStrictThreshold(qreal threshold)
+{
+    if (threshold < 0 || threshold >= 1) {
+        qWarning("WPEProfile: %s.strictThreshold must be between 0 and 1", m_name);
+        return;
+    }
+    if (qFuzzyCompare(threshold + 1, m_strictThreshold + 1) || !checkNotApplied("strictThreshold"))
+        return;
+
+    m_strictThreshold = threshold;
+    Q_EMIT strictThresholdChanged();
+}
+
+/*!
+  \qmlproperty real WPEMemoryPressureSettings::killThreshold
+
+  The fraction of \l memoryLimit above which the process is terminated. It
+  may exceed \c 1 and must be higher than \l strictThreshold. The default
+  value, \c 0, never terminates the process.
+
+  \sa {WPEView::webProcessTerminated()}
+*/
+void WPEQtMemoryPressureSettings::setKillThreshold(qreal threshold)
+{
+    threshold = std::max<qreal>(threshold, 0);
+    if (qFuzzyCompare(threshold + 1, m_killThreshold + 1) || !checkNotApplied("killThreshold"))
+        return;
+
+    m_killThreshold = threshold;
+    Q_EMIT killThresholdChanged();
+}
+
+/*!
+  \qmlproperty real WPEMemoryPressureSettings::pollInterval
+
+  The interval in seconds at which the process checks its memory use.
+*/
+void WPEQtMemoryPressureSettings::setPollInterval(qreal pollInterval)
+{
+    pollInterval = std::max<qreal>(pollInterval, 0);
+    if (qFuzzyCompare(pollInterval + 1, m_pollInterval + 1) || !checkNotApplied("pollInterval"))
+        return;
+
+    m_pollInterval = pollInterval;
+    Q_EMIT pollIntervalChanged();
+}
+
+// Returns new settings owned by the caller, or nullptr when the WebKit
+// defaults are kept. Either way the settings cannot be changed afterwards.
+WebKitMemoryPressureSettings* WPEQtMemoryPressureSettings::apply()
+{
+    m_applied = true;
+    if (isDefault())
+        return nullptr;
+
+    auto* settings = webkit_memory_pressure_settings_new();
+    if (m_memoryLimit)
+        webkit_memory_pressure_settings_set_memory_limit(settings, m_memoryLimit);
+    if (m_pollInterval)
+        webkit_memory_pressure_settings_set_poll_interval(settings, m_pollInterval);
+
+    // WebKit validates each threshold against the current value of the other
+    // ones, so check the resulting configuration and apply it in an order that
+    // keeps the intermediate states valid.
+    const double conservative = m_conservativeThreshold ? m_conservativeThreshold : webkit_memory_pressure_settings_get_conservative_threshold(settings);
+    const double strict = m_strictThreshold ? m_strictThreshold : webkit_memory_pressure_settings_get_strict_threshold(settings);
+    if (conservative >= strict) {
+        qWarning("WPEProfile: %s.conservativeThreshold must be lower than strictThreshold, ignoring thresholds", m_name);
+        return settings;
+    }
+    double kill = m_killThreshold;
+    if (kill && kill <= strict) {
+        qWarning("WPEProfile: %s.killThreshold must be higher than strictThreshold, ignoring it", m_name);
+        kill = 0;
+    }
+
+    if (strict > webkit_memory_pressure_settings_get_strict_threshold(settings)) {
+        webkit_memory_pressure_settings_set_strict_threshold(settings, strict);
+        webkit_memory_pressure_settings_set_conservative_threshold(settings, conservative);
+    } else {
+        webkit_memory_pressure_settings_set_conservative_threshold(settings, conservative);
+        webkit_memory_pressure_settings_set_strict_threshold(settings, strict);
+    }
+    if (kill)
+        webkit_memory_pressure_settings_set_kill_threshold(settings, kill);
+
+    return settings;
+}
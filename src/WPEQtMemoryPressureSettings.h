@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QObject>
+#include <wpe/webkit.h>
+
+class WPEQtMemoryPressureSettings : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtMemoryPressureSettings)
+    Q_PROPERTY(int memoryLimit READ memoryLimit WRITE setMemoryLimit NOTIFY memoryLimitChanged)
+    Q_PROPERTY(qreal conservativeThreshold READ conservativeThreshold WRITE setConservativeThreshold NOTIFY conservativeThresholdChanged)
+    Q_PROPERTY(qreal strictThreshold READ strictThreshold WRITE setStrictThreshold NOTIFY strictThresholdChanged)
+    Q_PROPERTY(qreal killThreshold READ killThreshold WRITE setKillThreshold NOTIFY killThresholdChanged)
+    Q_PROPERTY(qreal pollInterval READ pollInterval WRITE setPollInterval NOTIFY pollIntervalChanged)
+
+public:
+    WPEQtMemoryPressureSettings(const char* name, QObject* parent);
+
+    int memoryLimit() const { return m_memoryLimit; };
+    void setMemoryLimit(int);
+    qreal conservativeThreshold() const { return m_conservativeThreshold; };
+    void setConservativeThreshold(qreal);
+    qreal strictThreshold() const { return m_strictThreshold; };
+    void setStrictThreshold(qreal);
+    qreal killThreshold() const { return m_killThreshold; };
+    void setKillThreshold(qreal);
+    qreal pollInterval() const { return m_pollInterval; };
+    void setPollInterval(qreal);
+
+    bool isApplied() const { return m_applied; };
+    WebKitMemoryPressureSettings* apply();
+
+Q_SIGNALS:
+    void memoryLimitChanged();
+    void conservativeThresholdChanged();
+    void strictThresholdChanged();
+    void killThresholdChanged();
+    void pollIntervalChanged();
+
+private:
+    bool checkNotApplied(const char* property) const;
+    bool isDefault() const;
+
+    const char* m_name;
+    int m_memoryLimit { 0 };
+    qreal m_conservativeThreshold { 0 };
+    qreal m_strictThreshold { 0 };
+    qreal m_killThreshold { 0 };
+    qreal m_pollInterval { 0 };
+    bool m_applied { false };
+};
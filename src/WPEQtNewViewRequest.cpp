@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtNewViewRequest.h"
+
+/*!
+  \qmltype WPENewViewRequest
+  \instantiates WPEQtNewViewRequest
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A utility type for \l {WPEView}'s \l {WPEView::}{newViewRequested()} signal.
+
+  The WPENewViewRequest type describes a request of the page to open a new
+  view, and lets the application supply the WPEView the new page is loaded in.
+
+  \sa {WPEView::newViewRequested()}{WPEView.newViewRequested()}
+*/
+WPEQtNewViewRequest::WPEQtNewViewRequest(const QUrl& url, bool userInitiated)
+    : m_url(url)
+    , m_userInitiated(userInitiated)
+{
+}
+
+/*!
+  \qmlproperty url WPENewViewRequest::url
+  \readonly
+
+  The URL requested to be loaded in the new view.
+*/
+
+/*!
+  \qmlproperty bool WPENewViewRequest::userInitiated
+  \readonly
+
+  Whether the request was triggered by a user gesture, as opposed to a
+  script opening a window on its own.
+*/
+
+/*!
+  \qmlproperty WPEView WPENewViewRequest::view
+
+  The view the new page should be loaded in, to be set by the signal handler.
+
+  The view must not have created its web view yet, which is best ensured
+  with the \c OnDemand \l {WPEView::}{createPolicy}, and it must be in a
+  window whose scene graph is initialized so that its web view can be created
+  right away. It then shares the web process and the profile of the opener,
+  and the new page keeps its \c window.opener relationship.
+*/
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "WPEQtView.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+
+class WPEQtNewViewRequest : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtNewViewRequest)
+    Q_PROPERTY(QUrl url READ url CONSTANT)
+    Q_PROPERTY(bool userInitiated READ isUserInitiated CONSTANT)
+    Q_PROPERTY(WPEQtView* view READ view WRITE setView)
+
+public:
+    WPEQtNewViewRequest(const QUrl&, bool userInitiated);
+
+    QUrl url() const { return m_url; };
+    bool isUserInitiated() const { return m_userInitiated; };
+    WPEQtView* view() const { return m_view; };
+    void setView(WPEQtView* view) { m_view = view; };
+
+private:
+    QUrl m_url;
+    bool m_userInitiated;
+    QPointer<WPEQtView> m_view;
+};
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtPermissionRequest.h"
+
+/*!
+  \qmltype WPEPermissionRequest
+  \instantiates WPEQtPermissionRequest
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A utility type for \l {WPEView}'s \l {WPEView::}{permissionRequested()} signal.
+
+  The WPEPermissionRequest type describes a permission requested by a page
+  that has no decision in the \l WPEProfile of the view. It can be answered
+  asynchronously, for instance after prompting the user; requests that are
+  never answered are denied when the view is destroyed.
+
+  \sa {WPEProfile::setPermission()}{WPEProfile.setPermission()}
+*/
+WPEQtPermissionRequest::WPEQtPermissionRequest(WebKitPermissionRequest* request, const QString& origin, int types, WPEQtProfile* profile, QObject* parent)
+    : QObject(parent)
+    , m_request(request)
+    , m_origin(origin)
+    , m_types(types)
+    , m_profile(profile)
+{
+}
+
+WPEQtPermissionRequest::~WPEQtPermissionRequest()
+{
+    if (m_request)
+        webkit_permission_request_deny(m_request.get());
+}
+
+int WPEQtPermissionRequest::permissionTypes(WebKitPermissionRequest* request)
+{
+    if (WEBKIT_IS_GEOLOCATION_PERMISSION_REQUEST(request))
+        return WPEQtProfile::GeolocationPermission;
+    if (WEBKIT_IS_USER_MEDIA_PERMISSION_REQUEST(request)) {
+        auto* mediaRequest = WEBKIT_USER_MEDIA_PERMISSION_REQUEST(request);
+        if (webkit_user_media_permission_is_for_display_device(mediaRequest))
+            return WPEQtProfile::DisplayCapturePermission;
+        int types = 0;
+        if (webkit_user_media_permission_is_for_video_device(mediaRequest))
+            types |= WPEQtProfile::CameraPermission;
+        if (webkit_user_media_permission_is_for_audio_device(mediaRequest))
+            types |= WPEQtProfile::MicrophonePermission;
+        return types ? types : WPEQtProfile::OtherPermission;
+    }
+    if (WEBKIT_IS_NOTIFICATION_PERMISSION_REQUEST(request))
+        return WPEQtProfile::NotificationPermission;
+    if (WEBKIT_IS_POINTER_LOCK_PERMISSION_REQUEST(request))
+        return WPEQtProfile::PointerLockPermission;
+    if (WEBKIT_IS_DEVICE_INFO_PERMISSION_REQUEST(request))
+        return WPEQtProfile::DeviceInfoPermission;
+    if (WEBKIT_IS_MEDIA_KEY_SYSTEM_PERMISSION_REQUEST(request))
+        return WPEQtProfile::MediaKeySystemPermission;
+    if (WEBKIT_IS_WEBSITE_DATA_ACCESS_PERMISSION_REQUEST(request))
+        return WPEQtProfile::WebsiteDataAccessPermission;
+#if WEBKIT_CHECK_VERSION(2, 42, 0)
+    if (WEBKIT_IS_CLIPBOARD_PERMISSION_REQUEST(request))
+        return WPEQtProfile::ClipboardPermission;
+#endif
+    return WPEQtProfile::OtherPermission;
+}
+
+/*!
+  \qmlproperty string WPEPermissionRequest::origin
+  \readonly
+
+  The origin of the committed page requesting the permission, the page that
+  delegated it for requests from frames. Empty when no page was committed
+  yet, in which case the decision is never remembered.
+*/
+
+/*!
+  \qmlproperty int WPEPermissionRequest::types
+  \readonly
+
+  The requested permission types, a combination of the
+  \l {WPEProfile::setPermission()}{WPEProfile} permission types. A page may
+  for instance request both \c CameraPermission and \c MicrophonePermission.
+*/
+
+/*!
+  \qmlproperty bool WPEPermissionRequest::decided
+  \readonly
+
+  Whether the request was answered.
+*/
+
+/*!
+  \qmlmethod void WPEPermissionRequest::allow(bool remember)
+
+  Grants the permission. Unless \a remember is \c false, the decision is
+  stored in the profile and later requests from the origin are granted
+  without asking.
+*/
+void WPEQtPermissionRequest::allow(bool remember)
+{
+    decide(WPEQtProfile::AllowPermission, remember);
+}
+
+/*!
+  \qmlmethod void WPEPermissionRequest::deny(bool remember)
+
+  Denies the permission. Unless \a remember is \c false, the decision is
+  stored in the profile and later requests from the origin are denied
+  without asking.
+*/
+void WPEQtPermissionRequest::deny(bool remember)
+{
+    decide(WPEQtProfile::DenyPermission, remember);
+}
+
+void WPEQtPermissionRequest::decide(WPEQtProfile::PermissionDecision decision, bool remember)
+{
+    if (!m_request)
+        return;
+
+    if (decision == WPEQtProfile::AllowPermission)
+        webkit_permission_request_allow(m_request.get());
+    else
+        webkit_permission_request_deny(m_request.get());
+    m_request = nullptr;
+
+    if (remember && m_profile && !m_origin.isEmpty())
+        m_profile->setPermission(m_origin, m_types, decision);
+
+    Q_EMIT decidedChanged();
+    deleteLater();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "WPEQtProfile.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+#include <wpe/webkit.h>
+#include <wtf/glib/GRefPtr.h>
+
+class WPEQtPermissionRequest : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtPermissionRequest)
+    Q_PROPERTY(QString origin READ origin CONSTANT)
+    Q_PROPERTY(int types READ types CONSTANT)
+    Q_PROPERTY(bool decided READ isDecided NOTIFY decidedChanged)
+
+public:
+    WPEQtPermissionRequest(WebKitPermissionRequest*, const QString& origin, int types, WPEQtProfile*, QObject* parent);
+    ~WPEQtPermissionRequest();
+
+    static int permissionTypes(WebKitPermissionRequest*);
+
+    QString origin() const { return m_origin; };
+    int types() const { return m_types; };
+    bool isDecided() const { return !m_request; };
+
+public Q_SLOTS:
+    void allow(bool remember = true);
+    void deny(bool remember = true);
+
+Q_SIGNALS:
+    void decidedChanged();
+
+private:
+    void decide(WPEQtProfile::PermissionDecision, bool remember);
+
+    GRefPtr<WebKitPermissionRequest> m_request;
+    QString m_origin;
+    int m_types;
+    QPointer<WPEQtProfile> m_profile;
+};
@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtProcessMonitor.h"
+
+#include "WPEQtView.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <algorithm>
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static quint64 ticksSinceBoot()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    return static_cast<quint64>(now.tv_sec) * ticksPerSecond + static_cast<quint64>(now.tv_nsec) * ticksPerSecond / 1000000000;
+}
+
+struct ProcessStat {
+    qint64 pid { 0 };
+    qint64 parentPid { 0 };
+    QByteArray name;
+    quint64 cpuTicks { 0 };
+    quint64 startTime { 0 };
+};
+
+static bool readProcessStat(qint64 pid, ProcessStat& stat)
+{
+    QFile file(QStringLiteral("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // The process name may contain spaces and parentheses, the fields follow the last one.
+    const QByteArray line = file.readAll();
+    const int nameStart = line.indexOf('(');
+    const int nameEnd = line.lastIndexOf(')');
+    if (nameStart < 0 || nameEnd < nameStart)
+        return false;
+
+    const QList<QByteArray> fields = line.mid(nameEnd + 2).split(' ');
+    // Fields are numbered from 3 (state) on: ppid is 4, utime 14, stime 15 and starttime 22.
+    if (fields.size() < 20)
+        return false;
+
+    stat.pid = pid;
+    stat.name = line.mid(nameStart + 1, nameEnd - nameStart - 1);
+    stat.parentPid = fields[1].toLongLong();
+    stat.cpuTicks = fields[11].toULongLong() + fields[12].toULongLong();
+    stat.startTime = fields[19].toULongLong();
+    return true;
+}
+
+static void readMemoryUsage(WPEQtProcessSample& sample)
+{
+    QFile file(QStringLiteral("/proc/%1/smaps_rollup").arg(sample.pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    auto value = [](const QByteArray& line) -> qint64 {
+        return line.mid(line.indexOf(':') + 1).trimmed().split(' ').first().toLongLong() * 1024;
+    };
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith("Rss:"))
+            sample.rss = value(line);
+        else if (line.startsWith("Pss:"))
+            sample.pss = value(line);
+        else if (line.startsWith("Anonymous:"))
+            sample.anonymous = value(line);
+        else if (line.startsWith("Swap:"))
+            sample.swap = value(line);
+    }
+}
+
+void WPEQtProcessSampler::sample()
+{
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    const qint64 self = QCoreApplication::applicationPid();
+    const quint64 now = ticksSinceBoot();
+
+    // Sandboxed processes are spawned through a launcher, so parents of parents are considered too.
+    QHash<qint64, ProcessStat> stats;
+    const QStringList entries = QDir(QStringLiteral("/proc")).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& entry : entries) {
+        bool isPid = false;
+        const qint64 pid = entry.toLongLong(&isPid);
+        ProcessStat stat;
+        if (isPid && readProcessStat(pid, stat))
+            stats.insert(pid, stat);
+    }
+
+    QVector<WPEQtProcessSample> samples;
+    QHash<qint64, QPair<quint64, quint64>> cpuTicks;
+    for (const auto& stat : stats) {
+        WPEQtProcessSample sample;
+        if (stat.name.startsWith("WPEWebProcess"))
+            sample.type = WPEQtProcessSample::WebProcess;
+        else if (stat.name.startsWith("WPENetworkProc"))
+            sample.type = WPEQtProcessSample::NetworkProcess;
+        else
+            continue;
+
+        const qint64 parent = stat.parentPid;
+        if (parent != self && stats.value(parent).parentPid != self)
+            continue;
+
+        sample.pid = stat.pid;
+        sample.startTime = stat.startTime;
+        sample.cpuTime = stat.cpuTicks * 1000 / ticksPerSecond;
+        const auto previous = m_previousCpuTicks.value(stat.pid, qMakePair(stat.cpuTicks, now));
+        if (now > previous.second)
+            sample.cpuUsage = static_cast<qreal>(stat.cpuTicks - previous.first) / (now - previous.second);
+        cpuTicks.insert(stat.pid, qMakePair(stat.cpuTicks, now));
+        readMemoryUsage(sample);
+        samples.append(sample);
+    }
+    m_previousCpuTicks = std::move(cpuTicks);
+
+    std::sort(samples.begin(), samples.end(), [](const WPEQtProcessSample& a, const WPEQtProcessSample& b) {
+        return a.startTime < b.startTime;
+    });
+    Q_EMIT sampled(samples);
+}
+
+void WPEQtProcessSampler::setPriorities(const WPEQtProcessPriorities& priorities)
+{
+    // Changing where background processes go requires placing them again.
+    if (priorities.backgroundCpus != m_priorities.backgroundCpus
+        || priorities.foregroundCgroup != m_priorities.foregroundCgroup
+        || priorities.backgroundCgroup != m_priorities.backgroundCgroup) {
+        for (auto it = m_appliedPriorities.begin(); it != m_appliedPriorities.end(); ++it)
+            it.value() = WPEQtView::AutomaticPriority;
+    }
+
+    m_priorities = priorities;
+    applyPriorities();
+}
+
+void WPEQtProcessSampler::applyPriorities()
+{
+    for (auto it = m_appliedPriorities.begin(); it != m_appliedPriorities.end();) {
+        if (m_priorities.priorities.contains(it.key()))
+            ++it;
+        else {
+            m_originalAffinities.remove(it.key());
+            it = m_appliedPriorities.erase(it);
+        }
+    }
+
+    for (auto it = m_priorities.priorities.cbegin(); it != m_priorities.priorities.cend(); ++it) {
+        // Processes that were never adjusted are left alone at normal priority.
+        const auto applied = m_appliedPriorities.constFind(it.key());
+        if (applied == m_appliedPriorities.cend() ? it.value() == WPEQtView::NormalPriority : applied.value() == it.value())
+            continue;
+
+        applyPriority(it.key(), it.value());
+        if (it.value() == WPEQtView::NormalPriority)
+            m_appliedPriorities.remove(it.key());
+        else
+            m_appliedPriorities.insert(it.key(), it.value());
+    }
+}
+
+void WPEQtProcessSampler::applyPriority(qint64 pid, WPEQtView::Priority priority)
+{
+    int nice = 0;
+    switch (priority) {
+    case WPEQtView::ForegroundPriority:
+        nice = -5;
+        break;
+    case WPEQtView::BackgroundPriority:
+        nice = 10;
+        break;
+    case WPEQtView::IdlePriority:
+        nice = 19;
+        break;
+    default:
+        break;
+    }
+
+    const bool background = priority == WPEQtView::BackgroundPriority || priority == WPEQtView::IdlePriority;
+    const bool confined = background && !m_priorities.backgroundCpus.isEmpty();
+    auto originalAffinity = m_originalAffinities.find(pid);
+    if (confined && originalAffinity == m_originalAffinities.end()) {
+        cpu_set_t affinity;
+        if (!sched_getaffinity(pid, sizeof(affinity), &affinity))
+            originalAffinity = m_originalAffinities.insert(pid, affinity);
+    }
+
+    // Processes that are not confined get the affinity they were started with back.
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (confined) {
+        for (int cpu : m_priorities.backgroundCpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpus);
+        }
+    } else if (originalAffinity != m_originalAffinities.end())
+        cpus = originalAffinity.value();
+    const bool setAffinity = confined || originalAffinity != m_originalAffinities.end();
+
+    // The nice value, scheduling policy and affinity are per thread on Linux;
+    // threads started later inherit them from the thread creating them.
+    const QStringList tasks = QDir(QStringLiteral("/proc/%1/task").arg(pid)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& task : tasks) {
+        const pid_t tid = task.toInt();
+        const int policy = priority == WPEQtView::IdlePriority ? SCHED_IDLE : SCHED_OTHER;
+        if (sched_getscheduler(tid) != policy) {
+            struct sched_param param = { };
+            sched_setscheduler(tid, policy, &param);
+        }
+        if (setpriority(PRIO_PROCESS, tid, nice) == -1 && !m_niceWarningShown) {
+            qWarning("WPEProcessMonitor: cannot set the nice value of web process %lld to %d: %s", pid, nice, strerror(errno));
+            m_niceWarningShown = true;
+        }
+        if (setAffinity)
+            sched_setaffinity(tid, sizeof(cpus), &cpus);
+    }
+    if (!confined)
+        m_originalAffinities.remove(pid);
+
+    const QString& cgroup = background ? m_priorities.backgroundCgroup : m_priorities.foregroundCgroup;
+    if (cgroup.isEmpty())
+        return;
+
+    QFile procs(QStringLiteral("%1/cgroup.procs").arg(cgroup));
+    if ((!procs.open(QIODevice::WriteOnly) || procs.write(QByteArray::number(pid)) == -1) && !m_cgroupWarningShown) {
+        qWarning("WPEProcessMonitor: cannot move web process %lld to %s: %s", pid, qPrintable(cgroup), qPrintable(procs.errorString()));
+        m_cgroupWarningShown = true;
+    }
+}
+
+/*!
+  \qmltype WPEProcessInfo
+  \instantiates WPEQtProcessInfo
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief Resource usage of the web process of a \l WPEView.
+
+  Memory sizes are in bytes. The values are sampled every
+  \l {WPEProcessMonitor::}{interval} milliseconds while the object is in use.
+
+  \sa {WPEView::processInfo}{WPEView.processInfo}, WPEProcessMonitor
+*/
+WPEQtProcessInfo::WPEQtProcessInfo(QObject* parent)
+    : QObject(parent)
+{
+    WPEQtProcessMonitor::singleton()->acquire();
+}
+
+WPEQtProcessInfo::~WPEQtProcessInfo()
+{
+    WPEQtProcessMonitor::singleton()->release();
+}
+
+void WPEQtProcessInfo::setSample(const WPEQtProcessSample& sample)
+{
+    m_sample = sample;
+    Q_EMIT updated();
+}
+
+/*!
+  \qmlproperty int WPEProcessInfo::pid
+  \readonly
+
+  The identifier of the web process, or \c 0 while it is not known.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::rss
+  \readonly
+
+  The resident set size of the web process.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::pss
+  \readonly
+
+  The proportional set size of the web process, where the pages shared with
+  other processes are accounted for proportionally.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::anonymousMemory
+  \readonly
+
+  The anonymous memory of the web process, which is mostly made of the
+  JavaScript and the malloc heaps.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::swap
+  \readonly
+
+  The amount of memory of the web process that is swapped out.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::cpuTime
+  \readonly
+
+  The CPU time consumed by the web process, in milliseconds.
+*/
+
+/*!
+  \qmlproperty real WPEProcessInfo::cpuUsage
+  \readonly
+
+  The CPU usage of the web process over the last interval, where \c 1 stands
+  for a fully used core.
+*/
+
+/*!
+  \qmltype WPEProcessMonitor
+  \instantiates WPEQtProcessMonitor
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A model of the WebKit auxiliary processes of the application.
+
+  WPEProcessMonitor is a singleton listing the web processes and the network
+  processes started for the views of the application, with their resource
+  usage. The statistics are read from \c /proc on a worker thread.
+
+  The model provides the \c pid, \c type (\c "web" or \c "network"),
+  \c urls (the URLs of the views rendered by the process), \c rss, \c pss,
+  \c anonymousMemory, \c swap, \c cpuTime and \c cpuUsage roles, with the
+  meaning documented for WPEProcessInfo.
+
+  The web process of a view is reported by the process itself, through the
+  web process extension installed with the plugin, every time a load
+  commits. It is unknown until the first load of the view commits, and
+  never known when the extension is not installed.
+
+  WPEProcessMonitor also applies the \l {WPEView::priority}{WPEView.priority}
+  of the views to their web processes, and decides where background web
+  processes run, see \l backgroundCpus and \l backgroundCgroup.
+
+  \badcode
+  ListView {
+      model: WPEProcessMonitor
+      delegate: Text { text: pid + " " + urls.join(", ") + ": " + (pss / 1048576).toFixed(1) + " MiB" }
+      Component.onCompleted: WPEProcessMonitor.enabled = true
+  }
+  \endcode
+*/
+WPEQtProcessMonitor* WPEQtProcessMonitor::singleton()
+{
+    static QPointer<WPEQtProcessMonitor> monitor;
+    if (!monitor)
+        monitor = new WPEQtProcessMonitor(QCoreApplication::instance());
+    return monitor;
+}
+
+WPEQtProcessMonitor::WPEQtProcessMonitor(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_sampler(new WPEQtProcessSampler)
+{
+    qRegisterMetaType<QVector<WPEQtProcessSample>>();
+    qRegisterMetaType<WPEQtProcessPriorities>();
+
+    m_sampler->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_sampler, &QObject::deleteLater);
+    connect(this, &WPEQtProcessMonitor::requestSample, m_sampler, &WPEQtProcessSampler::sample);
+    connect(this, &WPEQtProcessMonitor::requestPriorities, m_sampler, &WPEQtProcessSampler::setPriorities);
+    connect(m_sampler, &WPEQtProcessSampler::sampled, this, &WPEQtProcessMonitor::processSamples);
+
+    m_timer.setInterval(2000);
+    connect(&m_timer, &QTimer::timeout, this, [this] {
+        // Skip a tick rather than queueing samples behind a slow one.
+        if (m_samplePending)
+            return;
+        m_samplePending = true;
+        Q_EMIT requestSample();
+    });
+}
+
+WPEQtProcessMonitor::~WPEQtProcessMonitor()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/*!
+  \qmlproperty bool WPEProcessMonitor::enabled
+
+  Whether the processes are sampled. Sampling also happens while any
+  \l {WPEView::processInfo}{WPEView.processInfo} is in use, or any view has
+  a \l {WPEView::priority}{priority} other than \c WPEView.NormalPriority.
+  The default value is \c false.
+*/
+void WPEQtProcessMonitor::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled)
+        return;
+
+    m_enabled = enabled;
+    updateSampling();
+    Q_EMIT enabledChanged();
+}
+
+/*!
+  \qmlproperty int WPEProcessMonitor::interval
+
+  The sampling interval, in milliseconds. The default value is \c 2000.
+*/
+void WPEQtProcessMonitor::setInterval(int interval)
+{
+    interval = std::max(interval, 100);
+    if (interval == m_timer.interval())
+        return;
+
+    m_timer.setInterval(interval);
+    Q_EMIT intervalChanged();
+}
+
+/*!
+  \qmlproperty real WPEProcessMonitor::totalPss
+  \readonly
+
+  The proportional set size of all the listed processes, in bytes.
+*/
+qint64 WPEQtProcessMonitor::totalPss() const
+{
+    qint64 total = 0;
+    for (const auto& sample : m_samples)
+        total += sample.pss;
+    return total;
+}
+
+/*!
+  \qmlproperty list<int> WPEProcessMonitor::backgroundCpus
+
+  The CPUs web processes with \c WPEView.BackgroundPriority or
+  \c WPEView.IdlePriority are restricted to, for instance \c {[3]} to keep
+  background views off the cores used by the foreground view. Processes
+  get the affinity they had before back when their priority is raised. The
+  default, an empty list, does not restrict background processes.
+
+  \sa {WPEView::priority}{WPEView.priority}
+*/
+void WPEQtProcessMonitor::setBackgroundCpus(const QList<int>& backgroundCpus)
+{
+    if (backgroundCpus == m_priorities.backgroundCpus)
+        return;
+
+    m_priorities.backgroundCpus = backgroundCpus;
+    updatePriorities();
+    Q_EMIT backgroundCpusChanged();
+}
+
+/*!
+  \qmlproperty string WPEProcessMonitor::foregroundCgroup
+
+  The path of the cgroup, such as \c /sys/fs/cgroup/shell/foreground, web
+  processes are moved to when their priority is raised to
+  \c WPEView.ForegroundPriority, or back to \c WPEView.NormalPriority. Web
+  processes that never had their priority changed are not moved. The
+  application must be allowed to write to the \c cgroup.procs file of the
+  cgroup and of the cgroup the processes are moved from.
+
+  \sa backgroundCgroup
+*/
+void WPEQtProcessMonitor::setForegroundCgroup(const QString& foregroundCgroup)
+{
+    if (foregroundCgroup == m_priorities.foregroundCgroup)
+        return;
+
+    m_priorities.foregroundCgroup = foregroundCgroup;
+    updatePriorities();
+    Q_EMIT foregroundCgroupChanged();
+}
+
+/*!
+  \qmlproperty string WPEProcessMonitor::backgroundCgroup
+
+  The path of the cgroup web processes with \c WPEView.BackgroundPriority or
+  \c WPEView.IdlePriority are moved to, typically one with a low
+  \c cpu.weight or a \c cpu.max quota.
+
+  \sa foregroundCgroup
+*/
+void WPEQtProcessMonitor::setBackgroundCgroup(const QString& backgroundCgroup)
+{
+    if (backgroundCgroup == m_priorities.backgroundCgroup)
+        return;
+
+    m_priorities.backgroundCgroup = backgroundCgroup;
+    updatePriorities();
+    Q_EMIT backgroundCgroupChanged();
+}
+
+void WPEQtProcessMonitor::acquire()
+{
+    m_refCount++;
+    updateSampling();
+}
+
+void WPEQtProcessMonitor::release()
+{
+    if (m_refCount)
+        m_refCount--;
+    updateSampling();
+}
+
+void WPEQtProcessMonitor::updateSampling()
+{
+    const bool active = m_enabled || m_refCount || hasPrioritizedViews();
+    if (active == m_timer.isActive())
+        return;
+
+    if (!active) {
+        m_timer.stop();
+        return;
+    }
+
+    if (!m_thread.isRunning()) {
+        m_thread.setObjectName(QStringLiteral("WPEProcessMonitor"));
+        m_thread.start(QThread::LowPriority);
+    }
+    m_timer.start();
+    m_samplePending = true;
+    Q_EMIT requestSample();
+}
+
+void WPEQtProcessMonitor::registerView(WPEQtView* view)
+{
+    m_views.append({ view, 0, 0, 0, view->effectivePriority() });
+    updateSampling();
+}
+
+void WPEQtProcessMonitor::unregisterView(WPEQtView* view)
+{
+    m_views.erase(std::remove_if(m_views.begin(), m_views.end(), [view](const ViewEntry& entry) {
+        return !entry.view || entry.view == view;
+    }), m_views.end());
+    updateSampling();
+}
+
+void WPEQtProcessMonitor::webProcessTerminated(WPEQtView* view)
+{
+    for (auto& entry : m_views) {
+        if (entry.view == view)
+            entry = { entry.view, 0, 0, 0, entry.priority };
+    }
+}
+
+void WPEQtProcessMonitor::setViewProcess(WPEQtView* view, qint64 pid, quint64 pidNamespace)
+{
+    bool changed = false;
+    for (auto& entry : m_views) {
+        if (entry.view != view)
+            continue;
+        entry.reportedPid = pid;
+        entry.pidNamespace = pidNamespace;
+        const qint64 resolvedPid = resolveProcess(pid, pidNamespace);
+        changed |= resolvedPid != entry.pid;
+        entry.pid = resolvedPid;
+    }
+    if (changed && hasPrioritizedViews())
+        updatePriorities();
+}
+
+qint64 WPEQtProcessMonitor::resolveProcess(qint64 reportedPid, quint64 pidNamespace) const
+{
+    static const quint64 ownPidNamespace = [] {
+        struct stat namespaceStat;
+        return !stat("/proc/self/ns/pid", &namespaceStat) ? static_cast<quint64>(namespaceStat.st_ino) : 0;
+    }();
+    if (!pidNamespace || pidNamespace == ownPidNamespace)
+        return reportedPid;
+
+    // A sandboxed process reports its identifier in its own namespace; it is
+    // the only web process of that namespace.
+    for (const auto& sample : m_samples) {
+        if (sample.type != WPEQtProcessSample::WebProcess)
+            continue;
+        struct stat namespaceStat;
+        if (!stat(QStringLiteral("/proc/%1/ns/pid").arg(sample.pid).toUtf8().constData(), &namespaceStat)
+            && static_cast<quint64>(namespaceStat.st_ino) == pidNamespace)
+            return sample.pid;
+    }
+    return 0;
+}
+
+void WPEQtProcessMonitor::setViewPriority(WPEQtView* view, WPEQtView::Priority priority)
+{
+    for (auto& entry : m_views) {
+        if (entry.view == view)
+            entry.priority = priority;
+    }
+    updateSampling();
+    updatePriorities();
+}
+
+bool WPEQtProcessMonitor::hasPrioritizedViews() const
+{
+    return std::any_of(m_views.begin(), m_views.end(), [](const ViewEntry& entry) {
+        return entry.view && entry.priority != WPEQtView::NormalPriority;
+    });
+}
+
+void WPEQtProcessMonitor::updatePriorities()
+{
+    // Processes shared by several views get the highest priority among them.
+    WPEQtProcessPriorities priorities = m_priorities;
+    for (const auto& entry : m_views) {
+        if (!entry.view || !entry.pid)
+            continue;
+        auto it = priorities.priorities.find(entry.pid);
+        if (it == priorities.priorities.end())
+            priorities.priorities.insert(entry.pid, entry.priority);
+        else if (entry.priority < it.value())
+            it.value() = entry.priority;
+    }
+    Q_EMIT requestPriorities(priorities);
+}
+
+void WPEQtProcessMonitor::assignProcesses()
+{
+    auto isAlive = [this](qint64 pid) {
+        return std::any_of(m_samples.begin(), m_samples.end(), [pid](const WPEQtProcessSample& sample) {
+            return sample.pid == pid && sample.type == WPEQtProcessSample::WebProcess;
+        });
+    };
+
+    // Reported processes may not have been sampled yet, and sandboxed ones
+    // are only found once they were.
+    for (auto& entry : m_views) {
+        if (!entry.reportedPid)
+            continue;
+        entry.pid = resolveProcess(entry.reportedPid, entry.pidNamespace);
+        if (entry.pid && !isAlive(entry.pid))
+            entry.pid = 0;
+    }
+}
+
+void WPEQtProcessMonitor::processSamples(const QVector<WPEQtProcessSample>& samples)
+{
+    m_samplePending = false;
+    unregisterView(nullptr);
+
+    bool samePids = samples.size() == m_samples.size();
+    for (int i = 0; samePids && i < samples.size(); ++i)
+        samePids = samples[i].pid == m_samples[i].pid;
+
+    if (samePids) {
+        m_samples = samples;
+        if (!m_samples.isEmpty())
+            Q_EMIT dataChanged(index(0), index(m_samples.size() - 1));
+    } else {
+        const int previousCount = m_samples.size();
+        beginResetModel();
+        m_samples = samples;
+        endResetModel();
+        if (previousCount != m_samples.size())
+            Q_EMIT countChanged();
+    }
+
+    assignProcesses();
+    if (hasPrioritizedViews())
+        updatePriorities();
+    for (const auto& entry : m_views) {
+        if (!entry.view || !entry.view->m_processInfo)
+            continue;
+
+        auto it = std::find_if(m_samples.begin(), m_samples.end(), [&entry](const WPEQtProcessSample& sample) {
+            return sample.pid == entry.pid;
+        });
+        entry.view->m_processInfo->setSample(it != m_samples.end() ? *it : WPEQtProcessSample());
+    }
+    Q_EMIT updated();
+}
+
+QStringList WPEQtProcessMonitor::urlsForProcess(qint64 pid) const
+{
+    QStringList urls;
+    for (const auto& entry : m_views) {
+        if (entry.view && entry.pid == pid)
+            urls.append(entry.view->url().toString());
+    }
+    return urls;
+}
+
+int WPEQtProcessMonitor::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_samples.size();
+}
+
+QVariant WPEQtProcessMonitor::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_samples.size())
+        return QVariant();
+
+    const auto& sample = m_samples[index.row()];
+    switch (role) {
+    case PidRole:
+        return sample.pid;
+    case TypeRole:
+        return sample.type == WPEQtProcessSample::WebProcess ? QStringLiteral("web") : QStringLiteral("network");
+    case UrlsRole:
+        return sample.type == WPEQtProcessSample::WebProcess ? urlsForProcess(sample.pid) : QStringList();
+    case RssRole:
+        return sample.rss;
+    case PssRole:
+        return sample.pss;
+    case AnonymousMemoryRole:
+        return sample.anonymous;
+    case SwapRole:
+        return sample.swap;
+    case CpuTimeRole:
+        return sample.cpuTime;
+    case CpuUsageRole:
+        return sample.cpuUsage;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> WPEQtProcessMonitor::roleNames() const
+{
+    return {
+        { PidRole, "pid" },
+        { TypeRole, "type" },
+        { UrlsRole, "urls" },
+        { RssRole, "rss" },
+        { PssRole, "pss" },
+        { AnonymousMemoryRole, "anonymousMemory" },
+        { SwapRole, "swap" },
+        { CpuTimeRole, "cpuTime" },
+        { CpuUsageRole, "cpuUsage" }
+    };
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+#include "WPEQtView.h"
+
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <sched.h>
+
+struct WPEQtProcessSample {
+    enum Type {
+        WebProcess,
+        NetworkProcess
+    };
+
+    qint64 pid { 0 };
+    Type type { WebProcess };
+    quint64 startTime { 0 };
+    qint64 rss { 0 };
+    qint64 pss { 0 };
+    qint64 anonymous { 0 };
+    qint64 swap { 0 };
+    qint64 cpuTime { 0 };
+    qreal cpuUsage { 0 };
+};
+
+Q_DECLARE_METATYPE(WPEQtProcessSample)
+
+struct WPEQtProcessPriorities {
+    QHash<qint64, WPEQtView::Priority> priorities;
+    QList<int> backgroundCpus;
+    QString foregroundCgroup;
+    QString backgroundCgroup;
+};
+
+Q_DECLARE_METATYPE(WPEQtProcessPriorities)
+
+class WPEQtProcessInfo : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtProcessInfo)
+    Q_PROPERTY(qint64 pid READ pid NOTIFY updated)
+    Q_PROPERTY(qint64 rss READ rss NOTIFY updated)
+    Q_PROPERTY(qint64 pss READ pss NOTIFY updated)
+    Q_PROPERTY(qint64 anonymousMemory READ anonymousMemory NOTIFY updated)
+    Q_PROPERTY(qint64 swap READ swap NOTIFY updated)
+    Q_PROPERTY(qint64 cpuTime READ cpuTime NOTIFY updated)
+    Q_PROPERTY(qreal cpuUsage READ cpuUsage NOTIFY updated)
+
+public:
+    explicit WPEQtProcessInfo(QObject* parent);
+    ~WPEQtProcessInfo();
+
+    qint64 pid() const { return m_sample.pid; };
+    qint64 rss() const { return m_sample.rss; };
+    qint64 pss() const { return m_sample.pss; };
+    qint64 anonymousMemory() const { return m_sample.anonymous; };
+    qint64 swap() const { return m_sample.swap; };
+    qint64 cpuTime() const { return m_sample.cpuTime; };
+    qreal cpuUsage() const { return m_sample.cpuUsage; };
+
+    void setSample(const WPEQtProcessSample&);
+
+Q_SIGNALS:
+    void updated();
+
+private:
+    WPEQtProcessSample m_sample;
+};
+
+// Reads the process statistics from /proc, off the GUI thread.
+class WPEQtProcessSampler : public QObject {
+    Q_OBJECT
+
+public Q_SLOTS:
+    void sample();
+    void setPriorities(const WPEQtProcessPriorities&);
+
+Q_SIGNALS:
+    void sampled(const QVector<WPEQtProcessSample>&);
+
+private:
+    void applyPriorities();
+    void applyPriority(qint64 pid, WPEQtView::Priority);
+
+    WPEQtProcessPriorities m_priorities;
+    // Priorities applied so far, per process.
+    QHash<qint64, WPEQtView::Priority> m_appliedPriorities;
+    // CPU affinity of the processes before it was first changed.
+    QHash<qint64, cpu_set_t> m_originalAffinities;
+    bool m_niceWarningShown { false };
+    bool m_cgroupWarningShown { false };
+    // CPU ticks and sampling time of the previous sample, per process.
+    QHash<qint64, QPair<quint64, quint64>> m_previousCpuTicks;
+};
+
+class WPEQtProcessMonitor : public QAbstractListModel {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtProcessMonitor)
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(qint64 totalPss READ totalPss NOTIFY updated)
+    Q_PROPERTY(QList<int> backgroundCpus READ backgroundCpus WRITE setBackgroundCpus NOTIFY backgroundCpusChanged)
+    Q_PROPERTY(QString foregroundCgroup READ foregroundCgroup WRITE setForegroundCgroup NOTIFY foregroundCgroupChanged)
+    Q_PROPERTY(QString backgroundCgroup READ backgroundCgroup WRITE setBackgroundCgroup NOTIFY backgroundCgroupChanged)
+
+public:
+    enum Role {
+        PidRole = Qt::UserRole + 1,
+        TypeRole,
+        UrlsRole,
+        RssRole,
+        PssRole,
+        AnonymousMemoryRole,
+        SwapRole,
+        CpuTimeRole,
+        CpuUsageRole
+    };
+
+    static WPEQtProcessMonitor* singleton();
+    ~WPEQtProcessMonitor();
+
+    bool isEnabled() const { return m_enabled; };
+    void setEnabled(bool);
+    int interval() const { return m_timer.interval(); };
+    void setInterval(int);
+    qint64 totalPss() const;
+    QList<int> backgroundCpus() const { return m_priorities.backgroundCpus; };
+    void setBackgroundCpus(const QList<int>&);
+    QString foregroundCgroup() const { return m_priorities.foregroundCgroup; };
+    void setForegroundCgroup(const QString&);
+    QString backgroundCgroup() const { return m_priorities.backgroundCgroup; };
+    void setBackgroundCgroup(const QString&);
+
+    void acquire();
+    void release();
+
+    void registerView(WPEQtView*);
+    void unregisterView(WPEQtView*);
+    void webProcessTerminated(WPEQtView*);
+    void setViewProcess(WPEQtView*, qint64 pid, quint64 pidNamespace);
+    void setViewPriority(WPEQtView*, WPEQtView::Priority);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex&, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+Q_SIGNALS:
+    void enabledChanged();
+    void intervalChanged();
+    void countChanged();
+    void updated();
+    void backgroundCpusChanged();
+    void foregroundCgroupChanged();
+    void backgroundCgroupChanged();
+    void requestSample();
+    void requestPriorities(const WPEQtProcessPriorities&);
+
+private:
+    explicit WPEQtProcessMonitor(QObject* parent);
+
+    struct ViewEntry {
+        QPointer<WPEQtView> view;
+        qint64 reportedPid { 0 };
+        quint64 pidNamespace { 0 };
+        qint64 pid { 0 };
+        WPEQtView::Priority priority { WPEQtView::NormalPriority };
+    };
+
+    void updateSampling();
+    void processSamples(const QVector<WPEQtProcessSample>&);
+    void assignProcesses();
+    qint64 resolveProcess(qint64 reportedPid, quint64 pidNamespace) const;
+    bool hasPrioritizedViews() const;
+    void updatePriorities();
+    QStringList urlsForProcess(qint64 pid) const;
+
+    bool m_enabled { false };
+    unsigned m_refCount { 0 };
+    bool m_samplePending { false };
+    QTimer m_timer;
+    QThread m_thread;
+    WPEQtProcessSampler* m_sampler;
+    QVector<WPEQtProcessSample> m_samples;
+    QVector<ViewEntry> m_views;
+    WPEQtProcessPriorities m_priorities;
+};
@@ -0,0 +1,1340 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtProfile.h"
+
+#include "WPEQtUriSchemeHandler.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QSaveFile>
+#include <algorithm>
+#include <dlfcn.h>
+#include <memory>
+#include <vector>
+#include <wtf/glib/GUniquePtr.h>
+
+/*!
+  \qmltype WPEProfile
+  \instantiates WPEQtProfile
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief Holds the state shared between \l {WPEView}s.
+
+  Views using the same profile share their network session, web context
+  and user content, such as content filters. Views that do not set
+  \l {WPEView::}{profile} use a default profile shared by the whole application.
+
+  Persistent profiles store their data below
+  \c{$XDG_DATA_HOME/<application name>/<storage name>} and their cache below
+  \c{$XDG_CACHE_HOME/<application name>/<storage name>}, see \l storageName.
+
+  Settings affecting storage, such as \l ephemeral and \l persistentCookies,
+  must be set before the first view using the profile is created.
+
+  \badcode
+  WPEProfile {
+      id: workProfile
+      storageName: "work"
+  }
+
+  WPEProfile {
+      id: guestProfile
+      ephemeral: true
+      cacheModel: WPEProfile.DocumentViewerCacheModel
+  }
+
+  WPEView {
+      profile: guestProfile
+      url: "https://example.com"
+  }
+  \endcode
+*/
+WPEQtProfile::WPEQtProfile(QObject* parent)
+    : QObject(parent)
+    , m_webProcessMemoryPressure(new WPEQtMemoryPressureSettings("webProcessMemoryPressure", this))
+    , m_networkProcessMemoryPressure(new WPEQtMemoryPressureSettings("networkProcessMemoryPressure", this))
+{
+    m_websiteDataTimer.setInterval(60 * 60 * 1000);
+    connect(&m_websiteDataTimer, &QTimer::timeout, this, [this] {
+        enforceDiskCacheSize();
+        enforceWebsiteDataBudget();
+    });
+}
+
+WPEQtProfile::~WPEQtProfile()
+{
+    saveWebsiteDataLastUsed();
+
+    for (auto* userScript : m_installedUserScripts)
+        webkit_user_script_unref(userScript);
+    for (auto* userStyleSheet : m_installedUserStyleSheets)
+        webkit_user_style_sheet_unref(userStyleSheet);
+}
+
+WPEQtProfile* WPEQtProfile::defaultProfile()
+{
+    static QPointer<WPEQtProfile> profile;
+    if (!profile) {
+        profile = new WPEQtProfile(QCoreApplication::instance());
+        profile->m_storageName = QStringLiteral("Default");
+    }
+    return profile;
+}
+
+static QString applicationDataDirectory()
+{
+    const auto appName = QCoreApplication::applicationName();
+    const auto dataHome = QString::fromUtf8(qgetenv("XDG_DATA_HOME"));
+    return QStringLiteral("%1/%2").arg(dataHome, appName);
+}
+
+// The web process extension installed next to the plugin, which reports the
+// identifier of the web processes. Empty when it was not built.
+static QString qtWebProcessExtensionsDirectory()
+{
+    Dl_info info;
+    if (!dladdr(reinterpret_cast<void*>(&qtWebProcessExtensionsDirectory), &info) || !info.dli_fname)
+        return QString();
+
+    const auto directory = QStringLiteral("%1/web-process-extensions").arg(QFileInfo(QString::fromUtf8(info.dli_fname)).absolutePath());
+    if (!QFileInfo::exists(QStringLiteral("%1/libqtwpe-web-process-extension.so").arg(directory)))
+        return QString();
+    return directory;
+}
+
+QString WPEQtProfile::dataDirectory() const
+{
+    if (!hasPersistentStorage())
+        return QString();
+    return QStringLiteral("%1/%2").arg(applicationDataDirectory(), m_storageName);
+}
+
+QString WPEQtProfile::cacheDirectory() const
+{
+    if (!hasPersistentStorage())
+        return QString();
+    const auto appName = QCoreApplication::applicationName();
+    const auto cacheHome = QString::fromUtf8(qgetenv("XDG_CACHE_HOME"));
+    return QStringLiteral("%1/%2/%3").arg(cacheHome, appName, m_storageName);
+}
+
+bool WPEQtProfile::hasPersistentStorage() const
+{
+    return !m_ephemeral && !m_storageName.isEmpty();
+}
+
+bool WPEQtProfile::checkNotRealized(const char* property) const
+{
+    if (!m_networkSession)
+        return true;
+
+    qWarning("WPEProfile: %s cannot be changed once a view using the profile has been created", property);
+    return false;
+}
+
+static WebKitCacheModel toWebKitCacheModel(WPEQtProfile::CacheModel cacheModel)
+{
+    switch (cacheModel) {
+    case WPEQtProfile::DocumentViewerCacheModel:
+        return WEBKIT_CACHE_MODEL_DOCUMENT_VIEWER;
+    case WPEQtProfile::DocumentBrowserCacheModel:
+        return WEBKIT_CACHE_MODEL_DOCUMENT_BROWSER;
+    case WPEQtProfile::WebBrowserCacheModel:
+        break;
+    }
+    return WEBKIT_CACHE_MODEL_WEB_BROWSER;
+}
+
+/*!
+  \qmlproperty enumeration WPEProfile::cacheModel
+
+  The caching strategy of the views using the profile.
+
+  \value WPEProfile.DocumentViewerCacheModel Disables the memory and disk caches,
+         minimizing memory use and disk writes.
+  \value WPEProfile.DocumentBrowserCacheModel Moderate caching, suited to
+         browsing a limited set of documents.
+  \value WPEProfile.WebBrowserCacheModel Aggressive caching for general browsing.
+         This is the default.
+*/
+void WPEQtProfile::setCacheModel(CacheModel cacheModel)
+{
+    if (cacheModel == m_cacheModel)
+        return;
+
+    m_cacheModel = cacheModel;
+    if (m_webContext)
+        webkit_web_context_set_cache_model(m_webContext.get(), toWebKitCacheModel(m_cacheModel));
+    Q_EMIT cacheModelChanged();
+}
+
+/*!
+  \qmlproperty int WPEProfile::diskCacheSize
+
+  The maximum size in bytes of the HTTP disk cache of the profile, stored
+  below its own \l storageName directory. The cache is checked when the
+  first view using the profile is created, after page loads at most once a
+  minute, and every \l websiteDataCheckInterval milliseconds. When it
+  exceeds the limit, the cached resources of the least recently used sites
+  are removed in the background until it fits again; other website data is
+  kept. The cache can exceed the limit between two checks. The default
+  value, \c 0, does not limit the cache size.
+*/
+void WPEQtProfile::setDiskCacheSize(qint64 diskCacheSize)
+{
+    diskCacheSize = std::max<qint64>(diskCacheSize, 0);
+    if (diskCacheSize == m_diskCacheSize)
+        return;
+
+    m_diskCacheSize = diskCacheSize;
+    enforceDiskCacheSize();
+    scheduleWebsiteDataChecks();
+    Q_EMIT diskCacheSizeChanged();
+}
+
+/*!
+  \qmlproperty bool WPEProfile::ephemeral
+
+  When \c true, the profile keeps all website data, including the cache and
+  cookies, in memory and never writes to disk. The default value is \c false.
+*/
+void WPEQtProfile::setEphemeral(bool ephemeral)
+{
+    if (ephemeral == m_ephemeral || !checkNotRealized("ephemeral"))
+        return;
+
+    m_ephemeral = ephemeral;
+    resetContentFilterStore();
+    Q_EMIT ephemeralChanged();
+}
+
+/*!
+  \qmlproperty string WPEProfile::storageName
+
+  The name of the subdirectory the profile stores its data and cache in.
+  Profiles with different names never share website data, cookies,
+  permissions or compiled content filters; using the same name for two
+  profiles alive at the same time is not supported. The name must be a
+  valid directory name.
+
+  The default profile uses \c Default. Other profiles have no name by
+  default and keep their data in memory, as if they were \l ephemeral,
+  until one is set.
+*/
+void WPEQtProfile::setStorageName(const QString& storageName)
+{
+    if (storageName == m_storageName || !checkNotRealized("storageName"))
+        return;
+
+    if (storageName.contains(QLatin1Char('/')) || storageName == QLatin1String(".") || storageName == QLatin1String("..")) {
+        qWarning("WPEProfile: storageName must be a valid directory name");
+        return;
+    }
+
+    m_storageName = storageName;
+    resetContentFilterStore();
+    Q_EMIT storageNameChanged();
+}
+
+/*!
+  \qmlproperty bool WPEProfile::persistentCookies
+
+  When \c false, cookies are only kept in memory, even for a persistent
+  profile. The default value is \c true.
+*/
+void WPEQtProfile::setPersistentCookies(bool persistentCookies)
+{
+    if (persistentCookies == m_persistentCookies || !checkNotRealized("persistentCookies"))
+        return;
+
+    m_persistentCookies = persistentCookies;
+    Q_EMIT persistentCookiesChanged();
+}
+
+WebKitNetworkSession* WPEQtProfile::networkSession()
+{
+    if (m_networkSession)
+        return m_networkSession.get();
+
+    applyNetworkProcessMemoryPressure();
+
+    if (!hasPersistentStorage()) {
+        if (!m_ephemeral)
+            qWarning("WPEProfile: no storageName set, website data of the profile is kept in memory");
+        m_networkSession = adoptGRef(webkit_network_session_new_ephemeral());
+        downloads()->attachSession(m_networkSession.get());
+        return m_networkSession.get();
+    }
+
+    const auto dataDirRoot = QStringLiteral("%1/data").arg(dataDirectory());
+    const auto cookiesFile = QStringLiteral("%1/cookies.sqlite").arg(dataDirectory());
+
+    m_networkSession = adoptGRef(webkit_network_session_new(dataDirRoot.toUtf8().constData(), cacheDirectory().toUtf8().constData()));
+    webkit_network_session_set_persistent_credential_storage_enabled(m_networkSession.get(), TRUE);
+
+    if (m_persistentCookies) {
+        auto* cookieManager = webkit_network_session_get_cookie_manager(m_networkSession.get());
+        webkit_cookie_manager_set_persistent_storage(cookieManager, cookiesFile.toUtf8().constData(), WEBKIT_COOKIE_PERSISTENT_STORAGE_SQLITE);
+    }
+
+    if (m_diskCacheSize)
+        enforceDiskCacheSize();
+    scheduleWebsiteDataChecks();
+    downloads()->attachSession(m_networkSession.get());
+
+    return m_networkSession.get();
+}
+
+/*!
+  \qmlproperty WPEDownloadModel WPEProfile::downloads
+  \readonly
+
+  The downloads started by the views using the profile.
+*/
+WPEQtDownloadModel* WPEQtProfile::downloads()
+{
+    if (!m_downloads)
+        m_downloads = new WPEQtDownloadModel(this);
+    return m_downloads;
+}
+
+/*!
+  \qmlproperty WPEMemoryPressureSettings WPEProfile::webProcessMemoryPressure
+  \readonly
+
+  The memory pressure settings of the web processes of the views using the
+  profile. They cannot be changed once a view using the profile has been
+  created.
+*/
+
+/*!
+  \qmlproperty WPEMemoryPressureSettings WPEProfile::networkProcessMemoryPressure
+  \readonly
+
+  The memory pressure settings of the network process. There is a single
+  network process for the application, so only the settings of the first
+  profile that creates a view are applied; later profiles customizing them
+  are reported as warnings.
+*/
+void WPEQtProfile::applyNetworkProcessMemoryPressure()
+{
+    static bool networkProcessConfigured = false;
+
+    auto* settings = m_networkProcessMemoryPressure->apply();
+    if (settings) {
+        if (networkProcessConfigured)
+            qWarning("WPEProfile: networkProcessMemoryPressure ignored, the network process has already been configured by another profile");
+        else
+            webkit_network_session_set_memory_pressure_settings(settings);
+        webkit_memory_pressure_settings_free(settings);
+    }
+    networkProcessConfigured = true;
+}
+
+WebKitWebContext* WPEQtProfile::webContext()
+{
+    if (m_webContext)
+        return m_webContext.get();
+
+    const auto extensionsDirRoot = QStringLiteral("%1/extensions").arg(applicationDataDirectory());
+    const auto qtExtensionsDir = qtWebProcessExtensionsDirectory();
+
+    auto* memoryPressureSettings = m_webProcessMemoryPressure->apply();
+    m_webContext = adoptGRef(WEBKIT_WEB_CONTEXT(g_object_new(WEBKIT_TYPE_WEB_CONTEXT, "memory-pressure-settings", memoryPressureSettings, nullptr)));
+    if (memoryPressureSettings)
+        webkit_memory_pressure_settings_free(memoryPressureSettings);
+    if (qtExtensionsDir.isEmpty())
+        webkit_web_context_set_web_process_extensions_directory(m_webContext.get(), extensionsDirRoot.toUtf8().constData());
+    else {
+        // The extension of the plugin loads the ones of the application.
+        webkit_web_context_set_web_process_extensions_directory(m_webContext.get(), qtExtensionsDir.toUtf8().constData());
+        webkit_web_context_set_web_process_extensions_initialization_user_data(m_webContext.get(), g_variant_new_string(extensionsDirRoot.toUtf8().constData()));
+    }
+    webkit_web_context_set_cache_model(m_webContext.get(), toWebKitCacheModel(m_cacheModel));
+    WPEQtUriSchemeHandler::installSchemes(m_webContext.get());
+
+    return m_webContext.get();
+}
+
+// The content stored by sites, evicted as a whole; cookies, HSTS state and
+// credentials are kept so that users stay logged in.
+static const WebKitWebsiteDataTypes evictedWebsiteDataTypes = static_cast<WebKitWebsiteDataTypes>(
+    WEBKIT_WEBSITE_DATA_DISK_CACHE | WEBKIT_WEBSITE_DATA_LOCAL_STORAGE | WEBKIT_WEBSITE_DATA_INDEXEDDB_DATABASES
+    | WEBKIT_WEBSITE_DATA_SERVICE_WORKER_REGISTRATIONS | WEBKIT_WEBSITE_DATA_DOM_CACHE);
+
+/*!
+  \qmlproperty int WPEProfile::websiteDataBudget
+
+  The maximum size in bytes of the website data stored by the profile: HTTP
+  cache, local storage, IndexedDB databases and service workers. When the
+  stored data exceeds it, the data of the least recently used sites is
+  removed in the background. Cookies and credentials are kept.
+
+  WebKit only reports the size of the disk cache of each site, so the
+  stored data is measured on disk, below the \l storageName directories of
+  the profile, and the size of the data other than the cache is spread
+  evenly over the sites storing some. A check can therefore remove less
+  than needed; the next one removes more. Use \l diskCacheSize to only
+  limit the cache.
+
+  The budget is checked when the first view using the profile is created and
+  then every \l websiteDataCheckInterval milliseconds. The default value,
+  \c 0, does not limit the stored data.
+
+  \sa websiteDataEvicted()
+*/
+void WPEQtProfile::setWebsiteDataBudget(qint64 websiteDataBudget)
+{
+    websiteDataBudget = std::max<qint64>(websiteDataBudget, 0);
+    if (websiteDataBudget == m_websiteDataBudget)
+        return;
+
+    m_websiteDataBudget = websiteDataBudget;
+    scheduleWebsiteDataChecks();
+    Q_EMIT websiteDataBudgetChanged();
+}
+
+/*!
+  \qmlproperty int WPEProfile::websiteDataCheckInterval
+
+  The interval in milliseconds at which \l websiteDataBudget and
+  \l diskCacheSize are enforced.
+  The default value is one hour.
+*/
+void WPEQtProfile::setWebsiteDataCheckInterval(int websiteDataCheckInterval)
+{
+    if (websiteDataCheckInterval == m_websiteDataTimer.interval())
+        return;
+
+    m_websiteDataTimer.setInterval(websiteDataCheckInterval);
+    Q_EMIT websiteDataCheckIntervalChanged();
+}
+
+void WPEQtProfile::scheduleWebsiteDataChecks()
+{
+    if (!m_networkSession || !hasPersistentStorage() || (!m_websiteDataBudget && !m_diskCacheSize)) {
+        m_websiteDataTimer.stop();
+        return;
+    }
+
+    if (!m_websiteDataTimer.isActive()) {
+        m_websiteDataTimer.start();
+        QTimer::singleShot(0, this, &WPEQtProfile::enforceWebsiteDataBudget);
+    }
+}
+
+void WPEQtProfile::noteOriginUsed(const QUrl& url)
+{
+    const QString host = url.host();
+    if (host.isEmpty() || !hasPersistentStorage())
+        return;
+
+    loadWebsiteDataLastUsed();
+    m_websiteDataLastUsed.insert(host, QDateTime::currentMSecsSinceEpoch());
+    m_websiteDataLastUsedDirty = true;
+
+    // The cache grows with every load, check it at most once a minute.
+    if (!m_diskCacheCheckClock.isValid() || m_diskCacheCheckClock.elapsed() > 60 * 1000)
+        enforceDiskCacheSize();
+}
+
+QDateTime WPEQtProfile::websiteDataLastUsed(const QString& name) const
+{
+    // Website data is grouped by registrable domain, while visits are recorded per host.
+    qint64 lastUsed = 0;
+    for (auto it = m_websiteDataLastUsed.constBegin(); it != m_websiteDataLastUsed.constEnd(); ++it) {
+        const QString& host = it.key();
+        if (host == name || host.endsWith(QLatin1Char('.') + name))
+            lastUsed = std::max(lastUsed, it.value());
+    }
+    return lastUsed ? QDateTime::fromMSecsSinceEpoch(lastUsed) : QDateTime();
+}
+
+void WPEQtProfile::loadWebsiteDataLastUsed()
+{
+    if (m_websiteDataLastUsedLoaded)
+        return;
+
+    m_websiteDataLastUsedLoaded = true;
+    if (!hasPersistentStorage())
+        return;
+
+    // Kept below the directory of the profile, usage is never mixed between profiles.
+    QFile file(QStringLiteral("%1/website-data-usage.json").arg(dataDirectory()));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject hosts = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = hosts.constBegin(); it != hosts.constEnd(); ++it)
+        m_websiteDataLastUsed.insert(it.key(), static_cast<qint64>(it.value().toDouble()));
+}
+
+void WPEQtProfile::saveWebsiteDataLastUsed()
+{
+    // Only written when the budget is checked and on exit, to keep flash writes down.
+    if (!m_websiteDataLastUsedDirty || !hasPersistentStorage())
+        return;
+
+    QJsonObject hosts;
+    for (auto it = m_websiteDataLastUsed.constBegin(); it != m_websiteDataLastUsed.constEnd(); ++it)
+        hosts.insert(it.key(), static_cast<double>(it.value()));
+
+    QDir().mkpath(dataDirectory());
+    QSaveFile file(QStringLiteral("%1/website-data-usage.json").arg(dataDirectory()));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(QJsonDocument(hosts).toJson(QJsonDocument::Compact));
+    if (file.commit())
+        m_websiteDataLastUsedDirty = false;
+}
+
+struct WebsiteDataFetchRequest {
+    QPointer<WPEQtProfile> profile;
+    std::function<void(WPEQtProfile&, GList*)> completionHandler;
+};
+
+static void fetchWebsiteData(WPEQtProfile& profile, std::function<void(WPEQtProfile&, GList*)>&& completionHandler)
+{
+    auto* manager = webkit_network_session_get_website_data_manager(profile.networkSession());
+    webkit_website_data_manager_fetch(manager, evictedWebsiteDataTypes, nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+        std::unique_ptr<WebsiteDataFetchRequest> request(static_cast<WebsiteDataFetchRequest*>(userData));
+        GUniqueOutPtr<GError> error;
+        GList* dataList = webkit_website_data_manager_fetch_finish(WEBKIT_WEBSITE_DATA_MANAGER(object), result, &error.outPtr());
+        if (error)
+            qWarning("WPEProfile: failed to fetch website data: %s", error->message);
+        if (request->profile)
+            request->completionHandler(*request->profile, dataList);
+        g_list_free_full(dataList, reinterpret_cast<GDestroyNotify>(webkit_website_data_unref));
+    }, new WebsiteDataFetchRequest { &profile, std::move(completionHandler) });
+}
+
+/*!
+  Asynchronously fetches the disk cache usage of every site with stored data
+  and passes it to \a callback. The work happens in the network process, the GUI
+  thread is never blocked.
+*/
+void WPEQtProfile::fetchWebsiteDataUsage(WebsiteDataUsageCallback&& callback)
+{
+    fetchWebsiteData(*this, [callback = std::move(callback)](WPEQtProfile& profile, GList* dataList) {
+        profile.loadWebsiteDataLastUsed();
+
+        QVector<WebsiteDataUsage> usage;
+        for (GList* item = dataList; item; item = g_list_next(item)) {
+            auto* data = static_cast<WebKitWebsiteData*>(item->data);
+            WebsiteDataUsage entry;
+            entry.name = QString::fromUtf8(webkit_website_data_get_name(data));
+            entry.diskCache = webkit_website_data_get_size(data, WEBKIT_WEBSITE_DATA_DISK_CACHE);
+            entry.lastUsed = profile.websiteDataLastUsed(entry.name);
+            usage.append(entry);
+        }
+        callback(usage);
+    });
+}
+
+/*!
+  \qmlmethod void WPEProfile::websiteDataUsage(variant callback)
+
+  Asynchronously fetches the disk usage of every site with stored data. The
+  \a callback receives a list of objects with the \c name of the site, the
+  size in bytes of its \c diskCache, and when the site was \c lastUsed.
+  WebKit does not report the size of the other data stored by sites.
+
+  \badcode
+  profile.websiteDataUsage(function(usage) {
+      usage.forEach(function(site) { console.log(site.name, site.diskCache); });
+  });
+  \endcode
+*/
+void WPEQtProfile::websiteDataUsage(const QJSValue& callback)
+{
+    QPointer<WPEQtProfile> profile(this);
+    fetchWebsiteDataUsage([profile, callback](const QVector<WebsiteDataUsage>& usage) {
+        QJSValue function(callback);
+        if (!profile || !function.isCallable())
+            return;
+
+        QQmlEngine* engine = qmlEngine(profile.data());
+        if (!engine) {
+            qWarning("No JavaScript engine, unable to handle website data usage callback!");
+            return;
+        }
+
+        QVariantList sites;
+        for (const auto& entry : usage) {
+            sites.append(QVariantMap {
+                { QStringLiteral("name"), entry.name },
+                { QStringLiteral("diskCache"), entry.diskCache },
+                { QStringLiteral("lastUsed"), entry.lastUsed },
+            });
+        }
+        function.call(QJSValueList { engine->toScriptValue(sites) });
+    });
+}
+
+/*!
+  \qmlmethod void WPEProfile::enforceWebsiteDataBudget()
+
+  Checks the stored website data against \l websiteDataBudget right away,
+  instead of waiting for the next periodic check.
+*/
+void WPEQtProfile::enforceWebsiteDataBudget()
+{
+    if (!m_networkSession || !hasPersistentStorage() || !m_websiteDataBudget || m_evictingWebsiteData)
+        return;
+
+    saveWebsiteDataLastUsed();
+    m_evictingWebsiteData = true;
+
+    // Walking the storage directories can take a while on flash, keep it off the GUI thread.
+    auto* task = g_task_new(nullptr, nullptr, [](GObject*, GAsyncResult* result, gpointer userData) {
+        std::unique_ptr<QPointer<WPEQtProfile>> profile(static_cast<QPointer<WPEQtProfile>*>(userData));
+        const qint64 storedSize = g_task_propagate_int(G_TASK(result), nullptr);
+        if (!*profile)
+            return;
+        fetchWebsiteData(**profile, [storedSize](WPEQtProfile& profile, GList* dataList) {
+            profile.evictWebsiteData(dataList, storedSize);
+        });
+    }, new QPointer<WPEQtProfile>(this));
+    g_task_set_task_data(task, new QStringList { QStringLiteral("%1/data").arg(dataDirectory()), cacheDirectory() }, [](gpointer directories) {
+        delete static_cast<QStringList*>(directories);
+    });
+    g_task_run_in_thread(task, [](GTask* task, gpointer, gpointer directories, GCancellable*) {
+        qint64 size = 0;
+        for (const auto& directory : *static_cast<QStringList*>(directories)) {
+            QDirIterator it(directory, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                size += it.fileInfo().size();
+            }
+        }
+        g_task_return_int(task, size);
+    });
+    g_object_unref(task);
+}
+
+// Returns the least recently used sites whose removal brings the size of
+// their data of the given types down to the budget, or nullptr if it fits.
+// The unaccounted size, stored data WebKit reports no size for, is spread
+// evenly over the sites that have data of the given types besides the cache.
+GList* WPEQtProfile::selectLeastRecentlyUsed(GList* dataList, WebKitWebsiteDataTypes types, qint64 budget, QStringList& names, qint64& selectedSize, qint64 unaccountedSize)
+{
+    loadWebsiteDataLastUsed();
+
+    struct Candidate {
+        WebKitWebsiteData* data;
+        qint64 size;
+        QDateTime lastUsed;
+    };
+    const auto unaccountedTypes = static_cast<WebKitWebsiteDataTypes>(types & ~WEBKIT_WEBSITE_DATA_DISK_CACHE);
+    int unaccountedSites = 0;
+    for (GList* item = dataList; item; item = g_list_next(item)) {
+        if (webkit_website_data_get_types(static_cast<WebKitWebsiteData*>(item->data)) & unaccountedTypes)
+            ++unaccountedSites;
+    }
+
+    std::vector<Candidate> candidates;
+    qint64 totalSize = 0;
+    for (GList* item = dataList; item; item = g_list_next(item)) {
+        auto* data = static_cast<WebKitWebsiteData*>(item->data);
+        qint64 size = webkit_website_data_get_size(data, types);
+        if (unaccountedSites && (webkit_website_data_get_types(data) & unaccountedTypes))
+            size += unaccountedSize / unaccountedSites;
+        totalSize += size;
+        candidates.push_back({ data, size, websiteDataLastUsed(QString::fromUtf8(webkit_website_data_get_name(data))) });
+    }
+
+    if (totalSize <= budget)
+        return nullptr;
+
+    // Sites never seen by a view sort first, as their invalid timestamp compares lowest.
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+
+    GList* selected = nullptr;
+    selectedSize = 0;
+    for (const auto& candidate : candidates) {
+        if (totalSize - selectedSize <= budget)
+            break;
+        selected = g_list_prepend(selected, webkit_website_data_ref(candidate.data));
+        names.append(QString::fromUtf8(webkit_website_data_get_name(candidate.data)));
+        selectedSize += candidate.size;
+    }
+    return selected;
+}
+
+void WPEQtProfile::evictWebsiteData(GList* dataList, qint64 storedSize)
+{
+    qint64 diskCacheSize = 0;
+    for (GList* item = dataList; item; item = g_list_next(item))
+        diskCacheSize += webkit_website_data_get_size(static_cast<WebKitWebsiteData*>(item->data), WEBKIT_WEBSITE_DATA_DISK_CACHE);
+
+    QStringList names;
+    qint64 evictedSize = 0;
+    GList* evicted = selectLeastRecentlyUsed(dataList, evictedWebsiteDataTypes, m_websiteDataBudget, names, evictedSize, std::max<qint64>(storedSize - diskCacheSize, 0));
+    if (!evicted) {
+        m_evictingWebsiteData = false;
+        return;
+    }
+
+    struct EvictionRequest {
+        QPointer<WPEQtProfile> profile;
+        GList* evicted;
+        QStringList names;
+        qint64 size;
+    };
+    auto* manager = webkit_network_session_get_website_data_manager(m_networkSession.get());
+    webkit_website_data_manager_remove(manager, evictedWebsiteDataTypes, evicted, nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+        std::unique_ptr<EvictionRequest> request(static_cast<EvictionRequest*>(userData));
+        GUniqueOutPtr<GError> error;
+        const bool removed = webkit_website_data_manager_remove_finish(WEBKIT_WEBSITE_DATA_MANAGER(object), result, &error.outPtr());
+        g_list_free_full(request->evicted, reinterpret_cast<GDestroyNotify>(webkit_website_data_unref));
+
+        if (!request->profile)
+            return;
+        request->profile->m_evictingWebsiteData = false;
+        if (!removed) {
+            qWarning("WPEProfile: failed to evict website data: %s", error->message);
+            return;
+        }
+        Q_EMIT request->profile->websiteDataEvicted(request->names, request->size);
+    }, new EvictionRequest { this, evicted, names, evictedSize });
+}
+
+void WPEQtProfile::enforceDiskCacheSize()
+{
+    if (!m_networkSession || !hasPersistentStorage() || !m_diskCacheSize || m_trimmingDiskCache)
+        return;
+
+    m_trimmingDiskCache = true;
+    m_diskCacheCheckClock.start();
+    fetchWebsiteData(*this, [](WPEQtProfile& profile, GList* dataList) {
+        profile.trimDiskCache(dataList);
+    });
+}
+
+void WPEQtProfile::trimDiskCache(GList* dataList)
+{
+    QStringList names;
+    qint64 trimmedSize = 0;
+    GList* trimmed = selectLeastRecentlyUsed(dataList, WEBKIT_WEBSITE_DATA_DISK_CACHE, m_diskCacheSize, names, trimmedSize);
+    if (!trimmed) {
+        m_trimmingDiskCache = false;
+        return;
+    }
+
+    struct TrimRequest {
+        QPointer<WPEQtProfile> profile;
+        GList* trimmed;
+    };
+    auto* manager = webkit_network_session_get_website_data_manager(m_networkSession.get());
+    webkit_website_data_manager_remove(manager, WEBKIT_WEBSITE_DATA_DISK_CACHE, trimmed, nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+        std::unique_ptr<TrimRequest> request(static_cast<TrimRequest*>(userData));
+        GUniqueOutPtr<GError> error;
+        if (!webkit_website_data_manager_remove_finish(WEBKIT_WEBSITE_DATA_MANAGER(object), result, &error.outPtr()))
+            qWarning("WPEProfile: failed to trim the disk cache: %s", error->message);
+        g_list_free_full(request->trimmed, reinterpret_cast<GDestroyNotify>(webkit_website_data_unref));
+        if (request->profile)
+            request->profile->m_trimmingDiskCache = false;
+    }, new TrimRequest { this, trimmed });
+}
+
+/*!
+  \qmlproperty bool WPEProfile::persistentPermissions
+
+  When \c true, the permission decisions of the profile are stored below
+  its own \l storageName directory and restored on the next run. Profiles
+  without persistent storage, such as \l ephemeral ones, never store them.
+
+  The default value is \c false.
+
+  \sa setPermission()
+*/
+void WPEQtProfile::setPersistentPermissions(bool persistentPermissions)
+{
+    if (persistentPermissions == m_persistentPermissions)
+        return;
+
+    m_persistentPermissions = persistentPermissions;
+    if (m_persistentPermissions) {
+        loadPermissions();
+        savePermissions();
+    }
+    Q_EMIT persistentPermissionsChanged();
+}
+
+/*!
+  Returns the origin permissions of pages loaded from \a url are granted to,
+  as used by \l setPermission().
+*/
+QString WPEQtProfile::permissionOrigin(const QUrl& url)
+{
+    if (url.isLocalFile())
+        return QStringLiteral("file://");
+    return url.adjusted(QUrl::RemoveUserInfo | QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment).toString();
+}
+
+static QString normalizedPermissionOrigin(const QString& origin)
+{
+    if (origin == QLatin1String("*"))
+        return origin;
+    return WPEQtProfile::permissionOrigin(QUrl(origin));
+}
+
+/*!
+  \qmlmethod void WPEProfile::setPermission(string origin, int types, enumeration decision)
+
+  Sets the \a decision taken when pages of \a origin request any of the
+  permission \a types, a combination of:
+
+  \value WPEProfile.GeolocationPermission Access to the position.
+  \value WPEProfile.CameraPermission Capture from cameras.
+  \value WPEProfile.MicrophonePermission Capture from microphones.
+  \value WPEProfile.DisplayCapturePermission Capture of the display.
+  \value WPEProfile.NotificationPermission Showing notifications.
+  \value WPEProfile.PointerLockPermission Locking the pointer.
+  \value WPEProfile.ClipboardPermission Reading the clipboard.
+  \value WPEProfile.DeviceInfoPermission Enumerating the media devices.
+  \value WPEProfile.MediaKeySystemPermission Using a DRM key system.
+  \value WPEProfile.WebsiteDataAccessPermission Accessing storage as a third party.
+  \value WPEProfile.OtherPermission Any other permission.
+
+  The \a decision is one of:
+
+  \value WPEProfile.AskPermission \l {WPEView::}{permissionRequested()} is emitted.
+  \value WPEProfile.AllowPermission The permission is granted.
+  \value WPEProfile.DenyPermission The permission is denied.
+
+  The \a origin is given as \c{scheme://host[:port]}, or \c "*" to set the
+  decision for origins without a decision of their own. Permissions that
+  are never set are asked for.
+
+  \badcode
+  Component.onCompleted: {
+      profile.setPermission("*", WPEProfile.CameraPermission | WPEProfile.MicrophonePermission, WPEProfile.DenyPermission)
+      profile.setPermission("https://maps.example.com", WPEProfile.GeolocationPermission, WPEProfile.AllowPermission)
+  }
+  \endcode
+*/
+void WPEQtProfile::setPermission(const QString& origin, int types, PermissionDecision decision)
+{
+    loadPermissions();
+
+    const QString key = normalizedPermissionOrigin(origin);
+    auto& decisions = m_permissions[key];
+    for (int type = GeolocationPermission; type <= OtherPermission; type <<= 1) {
+        if (!(types & type))
+            continue;
+        if (decision == AskPermission)
+            decisions.remove(type);
+        else
+            decisions.insert(type, decision);
+    }
+    if (decisions.isEmpty())
+        m_permissions.remove(key);
+
+    savePermissions();
+}
+
+/*!
+  \qmlmethod enumeration WPEProfile::permission(string origin, int types)
+
+  Returns the decision for pages of \a origin requesting all the permission
+  \a types: \c DenyPermission if any of them is denied, \c AllowPermission
+  if all of them are allowed, and \c AskPermission otherwise.
+
+  \sa setPermission()
+*/
+WPEQtProfile::PermissionDecision WPEQtProfile::permission(const QString& origin, int types)
+{
+    loadPermissions();
+
+    const auto originDecisions = m_permissions.value(normalizedPermissionOrigin(origin));
+    const auto defaultDecisions = m_permissions.value(QStringLiteral("*"));
+    bool allowed = true;
+    for (int type = GeolocationPermission; type <= OtherPermission; type <<= 1) {
+        if (!(types & type))
+            continue;
+        const auto decision = originDecisions.value(type, defaultDecisions.value(type, AskPermission));
+        if (decision == DenyPermission)
+            return DenyPermission;
+        allowed &= decision == AllowPermission;
+    }
+    return allowed && types ? AllowPermission : AskPermission;
+}
+
+/*!
+  \qmlmethod void WPEProfile::clearPermissions(string origin)
+
+  Forgets the permission decisions for \a origin, or for all the origins
+  when \a origin is not given.
+*/
+void WPEQtProfile::clearPermissions(const QString& origin)
+{
+    loadPermissions();
+
+    if (origin.isEmpty())
+        m_permissions.clear();
+    else
+        m_permissions.remove(normalizedPermissionOrigin(origin));
+    savePermissions();
+}
+
+/*!
+  \qmlmethod void WPEProfile::prefetchDns(string host)
+
+  Resolves \a host in the background, so that a later navigation to it does
+  not wait for the DNS lookup. Hosts prefetched in the last minute are not
+  resolved again.
+
+  This creates the network session of the profile if no view did yet, after
+  which the properties that must be set before, such as \l ephemeral, can
+  no longer be changed.
+
+  \sa {WPEView::prefetch()}{WPEView.prefetch()}
+*/
+void WPEQtProfile::prefetchDns(const QString& host)
+{
+    static const qint64 prefetchLifetime = 60 * 1000;
+
+    if (host.isEmpty())
+        return;
+
+    if (!m_prefetchClock.isValid())
+        m_prefetchClock.start();
+    const qint64 now = m_prefetchClock.elapsed();
+    const auto it = m_prefetchedHosts.constFind(host);
+    if (it != m_prefetchedHosts.cend() && now - it.value() < prefetchLifetime)
+        return;
+
+    if (m_prefetchedHosts.size() >= 256) {
+        for (auto expired = m_prefetchedHosts.begin(); expired != m_prefetchedHosts.end();) {
+            if (now - expired.value() >= prefetchLifetime)
+                expired = m_prefetchedHosts.erase(expired);
+            else
+                ++expired;
+        }
+    }
+    m_prefetchedHosts.insert(host, now);
+
+    webkit_network_session_prefetch_dns(networkSession(), host.toUtf8().constData());
+}
+
+void WPEQtProfile::loadPermissions()
+{
+    if (m_permissionsLoaded || !m_persistentPermissions || !hasPersistentStorage())
+        return;
+
+    m_permissionsLoaded = true;
+    QFile file(QStringLiteral("%1/permissions.json").arg(dataDirectory()));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    // Decisions set before the stored ones were loaded take precedence.
+    const QJsonObject origins = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = origins.constBegin(); it != origins.constEnd(); ++it) {
+        auto& decisions = m_permissions[it.key()];
+        const QJsonObject types = it.value().toObject();
+        for (auto type = types.constBegin(); type != types.constEnd(); ++type) {
+            const int decision = type.value().toInt();
+            if (decision != AllowPermission && decision != DenyPermission)
+                continue;
+            if (!decisions.contains(type.key().toInt()))
+                decisions.insert(type.key().toInt(), static_cast<PermissionDecision>(decision));
+        }
+    }
+}
+
+void WPEQtProfile::savePermissions()
+{
+    if (!m_persistentPermissions || !hasPersistentStorage())
+        return;
+
+    QJsonObject origins;
+    for (auto it = m_permissions.constBegin(); it != m_permissions.constEnd(); ++it) {
+        QJsonObject types;
+        for (auto type = it.value().constBegin(); type != it.value().constEnd(); ++type)
+            types.insert(QString::number(type.key()), static_cast<int>(type.value()));
+        origins.insert(it.key(), types);
+    }
+
+    QDir().mkpath(dataDirectory());
+    QSaveFile file(QStringLiteral("%1/permissions.json").arg(dataDirectory()));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(QJsonDocument(origins).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+WebKitUserContentManager* WPEQtProfile::userContentManager()
+{
+    if (!m_userContentManager) {
+        m_userContentManager = adoptGRef(webkit_user_content_manager_new());
+        updateUserContent();
+        if (m_webChannel)
+            m_webChannel->attach(m_userContentManager.get());
+    }
+    return m_userContentManager.get();
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+using QmlListIndex = qsizetype;
+#else
+using QmlListIndex = int;
+#endif
+
+/*!
+  \qmlproperty list<WPEUserScript> WPEProfile::userScripts
+
+  The scripts injected into the pages of every view using the profile. They
+  are installed once in the user content shared by the views, and changes
+  apply to the documents loaded afterwards.
+
+  \sa userStyleSheets
+*/
+QQmlListProperty<WPEQtUserScript> WPEQtProfile::userScripts()
+{
+    return QQmlListProperty<WPEQtUserScript>(this, nullptr,
+        [](QQmlListProperty<WPEQtUserScript>* list, WPEQtUserScript* userScript) {
+            static_cast<WPEQtProfile*>(list->object)->addUserScript(userScript);
+        },
+        [](QQmlListProperty<WPEQtUserScript>* list) -> QmlListIndex {
+            return static_cast<WPEQtProfile*>(list->object)->m_userScripts.size();
+        },
+        [](QQmlListProperty<WPEQtUserScript>* list, QmlListIndex index) {
+            return static_cast<WPEQtProfile*>(list->object)->m_userScripts.at(index);
+        },
+        [](QQmlListProperty<WPEQtUserScript>* list) {
+            static_cast<WPEQtProfile*>(list->object)->clearUserScripts();
+        });
+}
+
+/*!
+  \qmlproperty list<WPEUserStyleSheet> WPEProfile::userStyleSheets
+
+  The style sheets applied to the pages of every view using the profile.
+  Changes apply to the documents loaded afterwards.
+
+  \sa userScripts
+*/
+QQmlListProperty<WPEQtUserStyleSheet> WPEQtProfile::userStyleSheets()
+{
+    return QQmlListProperty<WPEQtUserStyleSheet>(this, nullptr,
+        [](QQmlListProperty<WPEQtUserStyleSheet>* list, WPEQtUserStyleSheet* userStyleSheet) {
+            static_cast<WPEQtProfile*>(list->object)->addUserStyleSheet(userStyleSheet);
+        },
+        [](QQmlListProperty<WPEQtUserStyleSheet>* list) -> QmlListIndex {
+            return static_cast<WPEQtProfile*>(list->object)->m_userStyleSheets.size();
+        },
+        [](QQmlListProperty<WPEQtUserStyleSheet>* list, QmlListIndex index) {
+            return static_cast<WPEQtProfile*>(list->object)->m_userStyleSheets.at(index);
+        },
+        [](QQmlListProperty<WPEQtUserStyleSheet>* list) {
+            static_cast<WPEQtProfile*>(list->object)->clearUserStyleSheets();
+        });
+}
+
+void WPEQtProfile::addUserScript(WPEQtUserScript* userScript)
+{
+    if (!userScript || m_userScripts.contains(userScript))
+        return;
+
+    m_userScripts.append(userScript);
+    connect(userScript, &WPEQtUserContent::changed, this, &WPEQtProfile::scheduleUserContentUpdate);
+    connect(userScript, &QObject::destroyed, this, [this, userScript] {
+        m_userScripts.removeAll(userScript);
+        scheduleUserContentUpdate();
+        Q_EMIT userScriptsChanged();
+    });
+    scheduleUserContentUpdate();
+    Q_EMIT userScriptsChanged();
+}
+
+void WPEQtProfile::addUserStyleSheet(WPEQtUserStyleSheet* userStyleSheet)
+{
+    if (!userStyleSheet || m_userStyleSheets.contains(userStyleSheet))
+        return;
+
+    m_userStyleSheets.append(userStyleSheet);
+    connect(userStyleSheet, &WPEQtUserContent::changed, this, &WPEQtProfile::scheduleUserContentUpdate);
+    connect(userStyleSheet, &QObject::destroyed, this, [this, userStyleSheet] {
+        m_userStyleSheets.removeAll(userStyleSheet);
+        scheduleUserContentUpdate();
+        Q_EMIT userStyleSheetsChanged();
+    });
+    scheduleUserContentUpdate();
+    Q_EMIT userStyleSheetsChanged();
+}
+
+/*!
+  \qmlproperty WPEWebChannel WPEProfile::webChannel
+
+  The channel publishing QObjects to the JavaScript of the pages loaded by
+  the views using the profile, or \c null.
+
+  \sa WPEWebChannel
+*/
+void WPEQtProfile::setWebChannel(WPEQtWebChannel* webChannel)
+{
+    if (webChannel == m_webChannel)
+        return;
+
+    if (m_webChannel && m_userContentManager)
+        m_webChannel->detach(m_userContentManager.get());
+    m_webChannel = webChannel;
+    if (m_webChannel && m_userContentManager)
+        m_webChannel->attach(m_userContentManager.get());
+    Q_EMIT webChannelChanged();
+}
+
+void WPEQtProfile::clearUserScripts()
+{
+    for (auto* userScript : m_userScripts)
+        disconnect(userScript, nullptr, this, nullptr);
+    m_userScripts.clear();
+    scheduleUserContentUpdate();
+    Q_EMIT userScriptsChanged();
+}
+
+void WPEQtProfile::clearUserStyleSheets()
+{
+    for (auto* userStyleSheet : m_userStyleSheets)
+        disconnect(userStyleSheet, nullptr, this, nullptr);
+    m_userStyleSheets.clear();
+    scheduleUserContentUpdate();
+    Q_EMIT userStyleSheetsChanged();
+}
+
+// Changes made together, such as the properties of a new script, are applied at once.
+void WPEQtProfile::scheduleUserContentUpdate()
+{
+    if (m_userContentUpdateScheduled || !m_userContentManager)
+        return;
+
+    m_userContentUpdateScheduled = true;
+    QMetaObject::invokeMethod(this, "updateUserContent", Qt::QueuedConnection);
+}
+
+void WPEQtProfile::updateUserContent()
+{
+    m_userContentUpdateScheduled = false;
+    auto* manager = m_userContentManager.get();
+    if (!manager)
+        return;
+
+    for (auto* userScript : m_installedUserScripts) {
+        webkit_user_content_manager_remove_script(manager, userScript);
+        webkit_user_script_unref(userScript);
+    }
+    m_installedUserScripts.clear();
+    for (auto* userStyleSheet : m_installedUserStyleSheets) {
+        webkit_user_content_manager_remove_style_sheet(manager, userStyleSheet);
+        webkit_user_style_sheet_unref(userStyleSheet);
+    }
+    m_installedUserStyleSheets.clear();
+
+    for (auto* item : m_userScripts) {
+        if (auto* userScript = item->userScript()) {
+            webkit_user_content_manager_add_script(manager, userScript);
+            m_installedUserScripts.append(webkit_user_script_ref(userScript));
+        }
+    }
+    for (auto* item : m_userStyleSheets) {
+        if (auto* userStyleSheet = item->userStyleSheet()) {
+            webkit_user_content_manager_add_style_sheet(manager, userStyleSheet);
+            m_installedUserStyleSheets.append(webkit_user_style_sheet_ref(userStyleSheet));
+        }
+    }
+}
+
+WebKitUserContentFilterStore* WPEQtProfile::contentFilterStore()
+{
+    if (!m_contentFilterStore) {
+        // Profiles without storage compile their lists on every run, in a
+        // directory of their own that is removed with the profile.
+        QString storePath;
+        if (hasPersistentStorage()) {
+            storePath = QStringLiteral("%1/content-filters").arg(dataDirectory());
+            QDir().mkpath(storePath);
+        } else {
+            m_temporaryContentFilterDirectory.reset(new QTemporaryDir);
+            storePath = m_temporaryContentFilterDirectory->path();
+        }
+        m_contentFilterStore = adoptGRef(webkit_user_content_filter_store_new(storePath.toUtf8().constData()));
+    }
+    return m_contentFilterStore.get();
+}
+
+void WPEQtProfile::resetContentFilterStore()
+{
+    // The store follows the storage of the profile, which QML can set after the lists.
+    if (!m_contentFilterStore)
+        return;
+
+    m_contentFilterStore = nullptr;
+    m_temporaryContentFilterDirectory.reset();
+    if (!m_contentFilters.isEmpty())
+        applyContentFilters();
+}
+
+/*!
+  \qmlproperty list<url> WPEProfile::contentFilters
+
+  The content blocking rule lists applied to every view using the profile,
+  as local or \c qrc: URLs of JSON files in the WebKit content extension format.
+
+  Each list is compiled once into a store below the data directory of the
+  profile and the compiled rules are reused on later launches, as long as the
+  JSON file is unchanged. Compiled rules no longer referenced by the profile
+  are removed from its store. Profiles without persistent storage compile
+  their lists in a temporary directory instead.
+
+  \sa contentFilterLoaded(), contentFilterFailed()
+*/
+void WPEQtProfile::setContentFilters(const QList<QUrl>& contentFilters)
+{
+    if (contentFilters == m_contentFilters)
+        return;
+
+    m_contentFilters = contentFilters;
+    applyContentFilters();
+    Q_EMIT contentFiltersChanged();
+}
+
+static QString contentFilterPath(const QUrl& url)
+{
+    if (url.isLocalFile())
+        return url.toLocalFile();
+    if (url.scheme() == QLatin1String("qrc"))
+        return QLatin1Char(':') + url.path();
+    return QString();
+}
+
+static QString contentFilterIdentifier(const QUrl& url, const QFileInfo& fileInfo)
+{
+    // Identify compiled lists by their source revision, so the JSON only has to be read on a cache miss.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url.toEncoded());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+struct ContentFilterRequest {
+    QPointer<WPEQtProfile> profile;
+    unsigned generation;
+    QUrl url;
+    QString identifier;
+    QString path;
+};
+
+void WPEQtProfile::applyContentFilters()
+{
+    ++m_contentFiltersGeneration;
+    webkit_user_content_manager_remove_all_filters(userContentManager());
+
+    QStringList identifiers;
+    for (const auto& url : m_contentFilters) {
+        const QString path = contentFilterPath(url);
+        QFileInfo fileInfo(path);
+        if (path.isEmpty() || !fileInfo.exists()) {
+            Q_EMIT contentFilterFailed(url, QStringLiteral("Content filters must be local or qrc: files"));
+            continue;
+        }
+
+        auto* request = new ContentFilterRequest { this, m_contentFiltersGeneration, url, contentFilterIdentifier(url, fileInfo), path };
+        identifiers.append(request->identifier);
+
+        webkit_user_content_filter_store_load(contentFilterStore(), request->identifier.toUtf8().constData(), nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+            std::unique_ptr<ContentFilterRequest> request(static_cast<ContentFilterRequest*>(userData));
+            auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(object);
+            if (auto* filter = webkit_user_content_filter_store_load_finish(store, result, nullptr)) {
+                if (request->profile)
+                    request->profile->addContentFilter(request->generation, request->url, filter);
+                webkit_user_content_filter_unref(filter);
+                return;
+            }
+
+            // Not compiled yet, or compiled by an incompatible WebKit version.
+            QFile file(request->path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                if (request->profile)
+                    Q_EMIT request->profile->contentFilterFailed(request->url, file.errorString());
+                return;
+            }
+            const QByteArray json = file.readAll();
+            GBytes* source = g_bytes_new(json.constData(), json.size());
+            auto* saveRequest = request.release();
+            webkit_user_content_filter_store_save(store, saveRequest->identifier.toUtf8().constData(), source, nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+                std::unique_ptr<ContentFilterRequest> request(static_cast<ContentFilterRequest*>(userData));
+                GUniqueOutPtr<GError> error;
+                auto* filter = webkit_user_content_filter_store_save_finish(WEBKIT_USER_CONTENT_FILTER_STORE(object), result, &error.outPtr());
+                if (!filter) {
+                    if (request->profile)
+                        Q_EMIT request->profile->contentFilterFailed(request->url, QString::fromUtf8(error->message));
+                    return;
+                }
+                if (request->profile)
+                    request->profile->addContentFilter(request->generation, request->url, filter);
+                webkit_user_content_filter_unref(filter);
+            }, saveRequest);
+            g_bytes_unref(source);
+        }, request);
+    }
+
+    removeStaleContentFilters(identifiers);
+}
+
+void WPEQtProfile::addContentFilter(unsigned generation, const QUrl& url, WebKitUserContentFilter* filter)
+{
+    // Drop results of lists replaced while they were being compiled.
+    if (generation != m_contentFiltersGeneration)
+        return;
+
+    webkit_user_content_manager_add_filter(userContentManager(), filter);
+    Q_EMIT contentFilterLoaded(url);
+}
+
+void WPEQtProfile::removeStaleContentFilters(const QStringList& identifiers)
+{
+    webkit_user_content_filter_store_fetch_identifiers(contentFilterStore(), nullptr, [](GObject* object, GAsyncResult* result, gpointer userData) {
+        std::unique_ptr<QStringList> identifiers(static_cast<QStringList*>(userData));
+        auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(object);
+        GUniquePtr<char*> storedIdentifiers(webkit_user_content_filter_store_fetch_identifiers_finish(store, result));
+        if (!storedIdentifiers)
+            return;
+
+        for (char** identifier = storedIdentifiers.get(); *identifier; ++identifier) {
+            if (!identifiers->contains(QString::fromUtf8(*identifier)))
+                webkit_user_content_filter_store_remove(store, *identifier, nullptr, nullptr, nullptr);
+        }
+    }, new QStringList(identifiers));
+}
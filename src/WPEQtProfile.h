@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+#include "WPEQtDownloadModel.h"
+#include "WPEQtMemoryPressureSettings.h"
+#include "WPEQtUserContent.h"
+#include "WPEQtWebChannel.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJSValue>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQmlListProperty>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+#include <functional>
+#include <memory>
+#include <wpe/webkit.h>
+#include <wtf/glib/GRefPtr.h>
+
+class WPEQtProfile : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtProfile)
+    Q_PROPERTY(QList<QUrl> contentFilters READ contentFilters WRITE setContentFilters NOTIFY contentFiltersChanged)
+    Q_PROPERTY(CacheModel cacheModel READ cacheModel WRITE setCacheModel NOTIFY cacheModelChanged)
+    Q_PROPERTY(qint64 diskCacheSize READ diskCacheSize WRITE setDiskCacheSize NOTIFY diskCacheSizeChanged)
+    Q_PROPERTY(bool ephemeral READ isEphemeral WRITE setEphemeral NOTIFY ephemeralChanged)
+    Q_PROPERTY(QString storageName READ storageName WRITE setStorageName NOTIFY storageNameChanged)
+    Q_PROPERTY(bool persistentCookies READ persistentCookies WRITE setPersistentCookies NOTIFY persistentCookiesChanged)
+    Q_PROPERTY(qint64 websiteDataBudget READ websiteDataBudget WRITE setWebsiteDataBudget NOTIFY websiteDataBudgetChanged)
+    Q_PROPERTY(int websiteDataCheckInterval READ websiteDataCheckInterval WRITE setWebsiteDataCheckInterval NOTIFY websiteDataCheckIntervalChanged)
+    Q_PROPERTY(WPEQtDownloadModel* downloads READ downloads CONSTANT)
+    Q_PROPERTY(bool persistentPermissions READ persistentPermissions WRITE setPersistentPermissions NOTIFY persistentPermissionsChanged)
+    Q_PROPERTY(WPEQtMemoryPressureSettings* webProcessMemoryPressure READ webProcessMemoryPressure CONSTANT)
+    Q_PROPERTY(WPEQtMemoryPressureSettings* networkProcessMemoryPressure READ networkProcessMemoryPressure CONSTANT)
+    Q_PROPERTY(QQmlListProperty<WPEQtUserScript> userScripts READ userScripts NOTIFY userScriptsChanged)
+    Q_PROPERTY(QQmlListProperty<WPEQtUserStyleSheet> userStyleSheets READ userStyleSheets NOTIFY userStyleSheetsChanged)
+    Q_PROPERTY(WPEQtWebChannel* webChannel READ webChannel WRITE setWebChannel NOTIFY webChannelChanged)
+    Q_ENUMS(CacheModel)
+    Q_ENUMS(PermissionType)
+    Q_ENUMS(PermissionDecision)
+
+public:
+    enum CacheModel {
+        DocumentViewerCacheModel,
+        DocumentBrowserCacheModel,
+        WebBrowserCacheModel
+    };
+
+    enum PermissionType {
+        GeolocationPermission = 1 << 0,
+        CameraPermission = 1 << 1,
+        MicrophonePermission = 1 << 2,
+        DisplayCapturePermission = 1 << 3,
+        NotificationPermission = 1 << 4,
+        PointerLockPermission = 1 << 5,
+        ClipboardPermission = 1 << 6,
+        DeviceInfoPermission = 1 << 7,
+        MediaKeySystemPermission = 1 << 8,
+        WebsiteDataAccessPermission = 1 << 9,
+        OtherPermission = 1 << 10
+    };
+
+    enum PermissionDecision {
+        AskPermission,
+        AllowPermission,
+        DenyPermission
+    };
+
+    struct WebsiteDataUsage {
+        QString name;
+        qint64 diskCache { 0 };
+        QDateTime lastUsed;
+    };
+    using WebsiteDataUsageCallback = std::function<void(const QVector<WebsiteDataUsage>&)>;
+
+    WPEQtProfile(QObject* parent = nullptr);
+    ~WPEQtProfile();
+
+    static WPEQtProfile* defaultProfile();
+
+    QList<QUrl> contentFilters() const { return m_contentFilters; };
+    void setContentFilters(const QList<QUrl>&);
+    CacheModel cacheModel() const { return m_cacheModel; };
+    void setCacheModel(CacheModel);
+    qint64 diskCacheSize() const { return m_diskCacheSize; };
+    void setDiskCacheSize(qint64);
+    bool isEphemeral() const { return m_ephemeral; };
+    void setEphemeral(bool);
+    QString storageName() const { return m_storageName; };
+    void setStorageName(const QString&);
+    bool persistentCookies() const { return m_persistentCookies; };
+    void setPersistentCookies(bool);
+    qint64 websiteDataBudget() const { return m_websiteDataBudget; };
+    void setWebsiteDataBudget(qint64);
+    int websiteDataCheckInterval() const { return m_websiteDataTimer.interval(); };
+    void setWebsiteDataCheckInterval(int);
+    bool persistentPermissions() const { return m_persistentPermissions; };
+    void setPersistentPermissions(bool);
+    WPEQtDownloadModel* downloads();
+    WPEQtMemoryPressureSettings* webProcessMemoryPressure() const { return m_webProcessMemoryPressure; };
+    WPEQtMemoryPressureSettings* networkProcessMemoryPressure() const { return m_networkProcessMemoryPressure; };
+    QQmlListProperty<WPEQtUserScript> userScripts();
+    QQmlListProperty<WPEQtUserStyleSheet> userStyleSheets();
+    void addUserScript(WPEQtUserScript*);
+    void addUserStyleSheet(WPEQtUserStyleSheet*);
+    void clearUserScripts();
+    void clearUserStyleSheets();
+    WPEQtWebChannel* webChannel() const { return m_webChannel; };
+    void setWebChannel(WPEQtWebChannel*);
+
+    Q_INVOKABLE void setPermission(const QString& origin, int types, WPEQtProfile::PermissionDecision);
+    Q_INVOKABLE WPEQtProfile::PermissionDecision permission(const QString& origin, int types);
+    Q_INVOKABLE void clearPermissions(const QString& origin = QString());
+    Q_INVOKABLE void prefetchDns(const QString& host);
+    static QString permissionOrigin(const QUrl&);
+
+    void fetchWebsiteDataUsage(WebsiteDataUsageCallback&&);
+    void noteOriginUsed(const QUrl&);
+
+    QString dataDirectory() const;
+    QString cacheDirectory() const;
+
+    WebKitNetworkSession* networkSession();
+    WebKitWebContext* webContext();
+    WebKitUserContentManager* userContentManager();
+
+public Q_SLOTS:
+    void websiteDataUsage(const QJSValue& callback);
+    void enforceWebsiteDataBudget();
+
+Q_SIGNALS:
+    void contentFiltersChanged();
+    void cacheModelChanged();
+    void diskCacheSizeChanged();
+    void ephemeralChanged();
+    void storageNameChanged();
+    void persistentCookiesChanged();
+    void websiteDataBudgetChanged();
+    void websiteDataCheckIntervalChanged();
+    void persistentPermissionsChanged();
+    void userScriptsChanged();
+    void userStyleSheetsChanged();
+    void webChannelChanged();
+    void websiteDataEvicted(const QStringList& names, qint64 size);
+    void contentFilterLoaded(const QUrl& url);
+    void contentFilterFailed(const QUrl& url, const QString& errorString);
+
+private Q_SLOTS:
+    void updateUserContent();
+
+private:
+    bool checkNotRealized(const char* property) const;
+    bool hasPersistentStorage() const;
+    void enforceDiskCacheSize();
+    void scheduleWebsiteDataChecks();
+    void evictWebsiteData(GList* dataList, qint64 storedSize);
+    void trimDiskCache(GList* dataList);
+    GList* selectLeastRecentlyUsed(GList* dataList, WebKitWebsiteDataTypes, qint64 budget, QStringList& names, qint64& selectedSize, qint64 unaccountedSize = 0);
+    void loadWebsiteDataLastUsed();
+    void saveWebsiteDataLastUsed();
+    QDateTime websiteDataLastUsed(const QString& name) const;
+    void loadPermissions();
+    void savePermissions();
+    void applyContentFilters();
+    void scheduleUserContentUpdate();
+    void applyNetworkProcessMemoryPressure();
+    void addContentFilter(unsigned generation, const QUrl&, WebKitUserContentFilter*);
+    void removeStaleContentFilters(const QStringList& identifiers);
+    WebKitUserContentFilterStore* contentFilterStore();
+    void resetContentFilterStore();
+
+    QList<QUrl> m_contentFilters;
+    unsigned m_contentFiltersGeneration { 0 };
+    CacheModel m_cacheModel { WebBrowserCacheModel };
+    qint64 m_diskCacheSize { 0 };
+    bool m_ephemeral { false };
+    QString m_storageName;
+    bool m_persistentCookies { true };
+    qint64 m_websiteDataBudget { 0 };
+    bool m_evictingWebsiteData { false };
+    bool m_trimmingDiskCache { false };
+    QElapsedTimer m_diskCacheCheckClock;
+    QTimer m_websiteDataTimer;
+    QHash<QString, qint64> m_websiteDataLastUsed;
+    bool m_websiteDataLastUsedLoaded { false };
+    bool m_websiteDataLastUsedDirty { false };
+    WPEQtDownloadModel* m_downloads { nullptr };
+    WPEQtMemoryPressureSettings* m_webProcessMemoryPressure;
+    WPEQtMemoryPressureSettings* m_networkProcessMemoryPressure;
+    bool m_persistentPermissions { false };
+    bool m_permissionsLoaded { false };
+    QHash<QString, QHash<int, PermissionDecision>> m_permissions;
+    QElapsedTimer m_prefetchClock;
+    QHash<QString, qint64> m_prefetchedHosts;
+    GRefPtr<WebKitNetworkSession> m_networkSession;
+    GRefPtr<WebKitWebContext> m_webContext;
+    GRefPtr<WebKitUserContentManager> m_userContentManager;
+    QList<WPEQtUserScript*> m_userScripts;
+    QList<WPEQtUserStyleSheet*> m_userStyleSheets;
+    QVector<WebKitUserScript*> m_installedUserScripts;
+    QVector<WebKitUserStyleSheet*> m_installedUserStyleSheets;
+    bool m_userContentUpdateScheduled { false };
+    QPointer<WPEQtWebChannel> m_webChannel;
+    std::unique_ptr<QTemporaryDir> m_temporaryContentFilterDirectory;
+    GRefPtr<WebKitUserContentFilterStore> m_contentFilterStore;
+};
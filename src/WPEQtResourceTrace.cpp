@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtResourceTrace.h"
+
+#include "WPEQtViewLoadRequest.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariantMap>
+#include <algorithm>
+
+WPEQtResourceTrace::WPEQtResourceTrace(WebKitWebView* webView, int capacity)
+    : m_webView(webView)
+    , m_capacity(std::max(capacity, 1))
+{
+    m_records.reserve(m_capacity);
+    g_signal_connect(m_webView.get(), "resource-load-started", G_CALLBACK(resourceLoadStartedCallback), this);
+}
+
+WPEQtResourceTrace::~WPEQtResourceTrace()
+{
+    g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(resourceLoadStartedCallback), this);
+    for (auto& pending : m_pendingResources)
+        disconnectResource(pending.second.resource.get());
+}
+
+void WPEQtResourceTrace::disconnectResource(WebKitWebResource* resource)
+{
+    g_signal_handlers_disconnect_by_func(resource, reinterpret_cast<gpointer>(resourceResponseCallback), this);
+    g_signal_handlers_disconnect_by_func(resource, reinterpret_cast<gpointer>(resourceFinishedCallback), this);
+    g_signal_handlers_disconnect_by_func(resource, reinterpret_cast<gpointer>(resourceFailedCallback), this);
+}
+
+template<typename Function>
+void WPEQtResourceTrace::forEachRecord(const Function& function) const
+{
+    // Once the buffer is full, m_next points to the oldest record.
+    const size_t start = m_records.size() < static_cast<size_t>(m_capacity) ? 0 : m_next;
+    for (size_t i = 0; i < m_records.size(); ++i)
+        function(m_records[(start + i) % m_records.size()]);
+}
+
+void WPEQtResourceTrace::setCapacity(int capacity)
+{
+    capacity = std::max(capacity, 1);
+    if (capacity == m_capacity)
+        return;
+
+    std::vector<Record> records;
+    records.reserve(capacity);
+    forEachRecord([&records](const Record& record) {
+        records.push_back(record);
+    });
+    if (records.size() > static_cast<size_t>(capacity))
+        records.erase(records.begin(), records.end() - capacity);
+
+    m_records = std::move(records);
+    m_capacity = capacity;
+    m_next = m_records.size() % m_capacity;
+    dropOverwrittenResources();
+}
+
+void WPEQtResourceTrace::clear()
+{
+    m_records.clear();
+    m_next = 0;
+    dropOverwrittenResources();
+}
+
+// Resources that never finish, such as long polls, would be tracked forever;
+// stop once their record is gone, as it can no longer be updated.
+void WPEQtResourceTrace::dropOverwrittenResources()
+{
+    // Every load gets a record, so the records hold the most recent ids.
+    const quint64 oldestId = m_lastId - m_records.size() + 1;
+    for (auto it = m_pendingResources.begin(); it != m_pendingResources.end();) {
+        if (it->second.id < oldestId) {
+            disconnectResource(it->second.resource.get());
+            it = m_pendingResources.erase(it);
+        } else
+            ++it;
+    }
+}
+
+WPEQtResourceTrace::Record* WPEQtResourceTrace::recordForResource(WebKitWebResource* resource)
+{
+    auto it = m_pendingResources.find(resource);
+    if (it == m_pendingResources.end())
+        return nullptr;
+
+    // Pending resources are usually among the most recent records, so look
+    // for it from the newest one. It may already have been overwritten.
+    const quint64 id = it->second.id;
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        auto& record = m_records[(m_next + m_records.size() - 1 - i) % m_records.size()];
+        if (record.id == id)
+            return &record;
+        if (record.id < id)
+            break;
+    }
+    return nullptr;
+}
+
+void WPEQtResourceTrace::resourceLoadStartedCallback(WebKitWebView* webView, WebKitWebResource* resource, WebKitURIRequest* request, WPEQtResourceTrace* trace)
+{
+    Record record;
+    record.id = ++trace->m_lastId;
+    record.url = QUrl(QString::fromUtf8(webkit_uri_request_get_uri(request)));
+    const char* method = webkit_uri_request_get_http_method(request);
+    record.method = method ? QByteArray(method) : QByteArrayLiteral("GET");
+    record.startedDateTime = QDateTime::currentDateTimeUtc();
+    record.startTime = WPEQtViewLoadRequest::monotonicTime();
+    record.mainResource = webkit_web_view_get_main_resource(webView) == resource;
+
+    if (trace->m_records.size() < static_cast<size_t>(trace->m_capacity))
+        trace->m_records.push_back(std::move(record));
+    else
+        trace->m_records[trace->m_next] = std::move(record);
+    trace->m_next = (trace->m_next + 1) % trace->m_capacity;
+
+    if (trace->m_pendingResources.size() >= static_cast<size_t>(trace->m_capacity))
+        trace->dropOverwrittenResources();
+    trace->m_pendingResources[resource] = { resource, trace->m_lastId };
+    g_signal_connect(resource, "notify::response", G_CALLBACK(resourceResponseCallback), trace);
+    g_signal_connect(resource, "finished", G_CALLBACK(resourceFinishedCallback), trace);
+    g_signal_connect(resource, "failed", G_CALLBACK(resourceFailedCallback), trace);
+
+    // Resources loaded from the memory cache already have their response.
+    if (webkit_web_resource_get_response(resource)) {
+        resourceResponseCallback(resource, nullptr, trace);
+        if (auto* pending = trace->recordForResource(resource))
+            pending->cacheHit = true;
+    }
+}
+
+void WPEQtResourceTrace::resourceResponseCallback(WebKitWebResource* resource, GParamSpec*, WPEQtResourceTrace* trace)
+{
+    auto* record = trace->recordForResource(resource);
+    auto* response = webkit_web_resource_get_response(resource);
+    if (!record || !response)
+        return;
+
+    record->responseTime = WPEQtViewLoadRequest::monotonicTime();
+    record->statusCode = webkit_uri_response_get_status_code(response);
+    record->mimeType = QString::fromUtf8(webkit_uri_response_get_mime_type(response));
+    const guint64 contentLength = webkit_uri_response_get_content_length(response);
+    if (contentLength)
+        record->size = contentLength;
+    if (record->statusCode == 304)
+        record->cacheHit = true;
+}
+
+void WPEQtResourceTrace::finishResource(WebKitWebResource* resource, GError* error)
+{
+    if (auto* record = recordForResource(resource)) {
+        record->endTime = WPEQtViewLoadRequest::monotonicTime();
+        if (record->responseTime < 0)
+            record->responseTime = record->endTime;
+        if (error)
+            record->errorString = QString::fromUtf8(error->message);
+    }
+
+    disconnectResource(resource);
+    m_pendingResources.erase(resource);
+}
+
+void WPEQtResourceTrace::resourceFinishedCallback(WebKitWebResource* resource, WPEQtResourceTrace* trace)
+{
+    trace->finishResource(resource, nullptr);
+}
+
+void WPEQtResourceTrace::resourceFailedCallback(WebKitWebResource* resource, GError* error, WPEQtResourceTrace* trace)
+{
+    trace->finishResource(resource, error);
+}
+
+QVariantList WPEQtResourceTrace::records() const
+{
+    QVariantList records;
+    forEachRecord([&records](const Record& record) {
+        QVariantMap map;
+        map.insert(QStringLiteral("url"), record.url);
+        map.insert(QStringLiteral("method"), QString::fromLatin1(record.method));
+        map.insert(QStringLiteral("mimeType"), record.mimeType);
+        map.insert(QStringLiteral("status"), record.statusCode);
+        map.insert(QStringLiteral("size"), record.size);
+        map.insert(QStringLiteral("startTime"), record.startTime);
+        map.insert(QStringLiteral("responseTime"), record.responseTime);
+        map.insert(QStringLiteral("endTime"), record.endTime);
+        map.insert(QStringLiteral("cacheHit"), record.cacheHit);
+        map.insert(QStringLiteral("mainResource"), record.mainResource);
+        map.insert(QStringLiteral("finished"), record.endTime >= 0);
+        map.insert(QStringLiteral("errorString"), record.errorString);
+        records.append(map);
+    });
+    return records;
+}
+
+QByteArray WPEQtResourceTrace::toHar() const
+{
+    QJsonArray entries;
+    forEachRecord([&entries](const Record& record) {
+        // HAR timings cannot be -1; phases not reached yet count as 0.
+        const qreal wait = record.responseTime >= 0 ? record.responseTime - record.startTime : 0;
+        const qreal receive = record.endTime >= 0 && record.responseTime >= 0 ? record.endTime - record.responseTime : 0;
+
+        QJsonObject request {
+            { QStringLiteral("method"), QString::fromLatin1(record.method) },
+            { QStringLiteral("url"), record.url.toString() },
+            { QStringLiteral("httpVersion"), QString() },
+            { QStringLiteral("cookies"), QJsonArray() },
+            { QStringLiteral("headers"), QJsonArray() },
+            { QStringLiteral("queryString"), QJsonArray() },
+            { QStringLiteral("headersSize"), -1 },
+            { QStringLiteral("bodySize"), -1 }
+        };
+        QJsonObject content {
+            { QStringLiteral("size"), std::max<qint64>(record.size, 0) },
+            { QStringLiteral("mimeType"), record.mimeType }
+        };
+        QJsonObject response {
+            { QStringLiteral("status"), record.statusCode },
+            { QStringLiteral("statusText"), QString() },
+            { QStringLiteral("httpVersion"), QString() },
+            { QStringLiteral("cookies"), QJsonArray() },
+            { QStringLiteral("headers"), QJsonArray() },
+            { QStringLiteral("content"), content },
+            { QStringLiteral("redirectURL"), QString() },
+            { QStringLiteral("headersSize"), -1 },
+            { QStringLiteral("bodySize"), record.cacheHit ? 0 : record.size }
+        };
+        if (!record.errorString.isEmpty())
+            response.insert(QStringLiteral("_error"), record.errorString);
+        QJsonObject timings {
+            { QStringLiteral("send"), 0 },
+            { QStringLiteral("wait"), wait },
+            { QStringLiteral("receive"), receive }
+        };
+
+        entries.append(QJsonObject {
+            { QStringLiteral("startedDateTime"), record.startedDateTime.toString(Qt::ISODateWithMs) },
+            { QStringLiteral("time"), wait + receive },
+            { QStringLiteral("request"), request },
+            { QStringLiteral("response"), response },
+            { QStringLiteral("cache"), QJsonObject() },
+            { QStringLiteral("timings"), timings },
+            { QStringLiteral("_cacheHit"), record.cacheHit },
+            { QStringLiteral("_finished"), record.endTime >= 0 }
+        });
+    });
+
+    return harDocument(entries);
+}
+
+QByteArray WPEQtResourceTrace::emptyHar()
+{
+    return harDocument(QJsonArray());
+}
+
+QByteArray WPEQtResourceTrace::harDocument(const QJsonArray& entries)
+{
+    QJsonObject creator {
+        { QStringLiteral("name"), QStringLiteral("wpewebkit-qt") },
+        { QStringLiteral("version"), QStringLiteral("1.0") }
+    };
+    QJsonObject log {
+        { QStringLiteral("version"), QStringLiteral("1.2") },
+        { QStringLiteral("creator"), creator },
+        { QStringLiteral("entries"), entries }
+    };
+    return QJsonDocument(QJsonObject { { QStringLiteral("log"), log } }).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QString>
+#include <QUrl>
+#include <QVariantList>
+#include <unordered_map>
+#include <vector>
+#include <wpe/webkit.h>
+#include <wtf/glib/GRefPtr.h>
+
+// Records the resource loads of a web view in a fixed size ring buffer, the
+// oldest records being overwritten once the buffer is full.
+class WPEQtResourceTrace {
+public:
+    struct Record {
+        quint64 id { 0 };
+        QUrl url;
+        QByteArray method;
+        QString mimeType;
+        QDateTime startedDateTime;
+        qreal startTime { -1 };
+        qreal responseTime { -1 };
+        qreal endTime { -1 };
+        qint64 size { -1 };
+        int statusCode { 0 };
+        bool cacheHit { false };
+        bool mainResource { false };
+        QString errorString;
+    };
+
+    WPEQtResourceTrace(WebKitWebView*, int capacity);
+    ~WPEQtResourceTrace();
+
+    int capacity() const { return m_capacity; };
+    void setCapacity(int);
+    void clear();
+
+    QVariantList records() const;
+    QByteArray toHar() const;
+    static QByteArray emptyHar();
+
+private:
+    static QByteArray harDocument(const QJsonArray& entries);
+    template<typename Function> void forEachRecord(const Function&) const;
+    Record* recordForResource(WebKitWebResource*);
+    void finishResource(WebKitWebResource*, GError*);
+    void disconnectResource(WebKitWebResource*);
+    void dropOverwrittenResources();
+
+    static void resourceLoadStartedCallback(WebKitWebView*, WebKitWebResource*, WebKitURIRequest*, WPEQtResourceTrace*);
+    static void resourceResponseCallback(WebKitWebResource*, GParamSpec*, WPEQtResourceTrace*);
+    static void resourceFinishedCallback(WebKitWebResource*, WPEQtResourceTrace*);
+    static void resourceFailedCallback(WebKitWebResource*, GError*, WPEQtResourceTrace*);
+
+    GRefPtr<WebKitWebView> m_webView;
+    int m_capacity;
+    std::vector<Record> m_records;
+    size_t m_next { 0 };
+    quint64 m_lastId { 0 };
+    struct PendingResource {
+        GRefPtr<WebKitWebResource> resource;
+        quint64 id;
+    };
+    std::unordered_map<WebKitWebResource*, PendingResource> m_pendingResources;
+};
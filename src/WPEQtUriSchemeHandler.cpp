@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtUriSchemeHandler.h"
+
+#include "WPEQtIODeviceInputStream.h"
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMimeDatabase>
+#include <QResource>
+#include <QVector>
+#include <wtf/glib/GRefPtr.h>
+#include <wtf/glib/GUniquePtr.h>
+
+namespace {
+
+class DirectorySchemeHandler final : public WPEQtUriSchemeHandler {
+public:
+    explicit DirectorySchemeHandler(const QString& rootPath)
+        : m_rootPath(rootPath)
+    { }
+
+    std::unique_ptr<QIODevice> open(const QUrl& url, QString&) override
+    {
+        // Both scheme:/path and scheme://host/path map below the root.
+        const QString relativePath = QDir::cleanPath(QStringLiteral("/%1%2").arg(url.host(QUrl::FullyDecoded), url.path(QUrl::FullyDecoded)));
+        if (relativePath.startsWith(QLatin1String("/..")))
+            return nullptr;
+
+        return std::make_unique<QFile>(m_rootPath + relativePath);
+    }
+
+private:
+    QString m_rootPath;
+};
+
+struct SchemeRegistration {
+    std::shared_ptr<WPEQtUriSchemeHandler> handler;
+    bool local { false };
+};
+
+}
+
+static QHash<QString, SchemeRegistration>& schemeRegistry()
+{
+    static QHash<QString, SchemeRegistration> registry {
+        { QStringLiteral("qrc"), { std::make_shared<DirectorySchemeHandler>(QStringLiteral(":")), true } }
+    };
+    return registry;
+}
+
+// Web contexts the schemes are installed in, so that schemes registered
+// later are also served to the profiles that already have views.
+static QVector<WebKitWebContext*>& installedContexts()
+{
+    static QVector<WebKitWebContext*> contexts;
+    return contexts;
+}
+
+static void installScheme(WebKitWebContext*, const QString& scheme, bool local);
+
+/*!
+  Registers \a handler to serve every request to \a scheme, replacing any
+  previous handler for the scheme. Registrations apply to every web view,
+  including the ones already created; a handler replaced while a request is
+  being served only affects the requests made afterwards. The \c qrc scheme
+  is registered by default and serves files from the Qt resource system.
+
+  Responses are streamed: resources stored uncompressed in the Qt resource system
+  and regular files opened through QFile are handed to WebKit without copying,
+  any other device is read incrementally.
+*/
+void WPEQtUriSchemeHandler::registerScheme(const QString& scheme, std::shared_ptr<WPEQtUriSchemeHandler> handler)
+{
+    auto& registry = schemeRegistry();
+    const bool installed = registry.contains(scheme);
+    registry.insert(scheme, { std::move(handler), false });
+    if (installed)
+        return;
+
+    for (auto* context : installedContexts())
+        installScheme(context, scheme, false);
+}
+
+/*!
+  Convenience to serve \a scheme from the files below \a rootPath, which may be
+  a filesystem directory or a Qt resource prefix such as \c{:/webapp}.
+*/
+void WPEQtUriSchemeHandler::registerDirectory(const QString& scheme, const QString& rootPath)
+{
+    registerScheme(scheme, std::make_shared<DirectorySchemeHandler>(QDir::cleanPath(rootPath)));
+}
+
+static GRefPtr<GBytes> mappedBytes(std::unique_ptr<QIODevice>& device)
+{
+    auto* file = qobject_cast<QFile*>(device.get());
+    if (!file || !file->size())
+        return nullptr;
+
+    if (file->fileName().startsWith(QLatin1Char(':'))) {
+        QResource resource(file->fileName());
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 13, 0))
+        const bool compressed = resource.compressionAlgorithm() != QResource::NoCompression;
+#else
+        const bool compressed = resource.isCompressed();
+#endif
+        if (!resource.isValid() || compressed || !resource.data())
+            return nullptr;
+        // Resource data is mapped for the lifetime of the process.
+        return adoptGRef(g_bytes_new_static(resource.data(), resource.size()));
+    }
+
+    const qint64 size = file->size();
+    uchar* data = file->map(0, size);
+    if (!data)
+        return nullptr;
+
+    // Destroying the file unmaps it once WebKit releases the bytes.
+    return adoptGRef(g_bytes_new_with_free_func(data, size, [](gpointer file) {
+        delete static_cast<QFile*>(file);
+    }, device.release()));
+}
+
+static void uriSchemeRequestCallback(WebKitURISchemeRequest* request, gpointer userData)
+{
+    // Handlers are looked up for every request, as they can be replaced at any time.
+    std::shared_ptr<WPEQtUriSchemeHandler> handler = schemeRegistry().value(*static_cast<QString*>(userData)).handler;
+    const QUrl url(QString::fromUtf8(webkit_uri_scheme_request_get_uri(request)));
+
+    QString mimeType;
+    std::unique_ptr<QIODevice> device = handler ? handler->open(url, mimeType) : nullptr;
+    if (!device || (!device->isOpen() && !device->open(QIODevice::ReadOnly))) {
+        GUniquePtr<GError> error(g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "Cannot load %s", webkit_uri_scheme_request_get_uri(request)));
+        webkit_uri_scheme_request_finish_error(request, error.get());
+        return;
+    }
+
+    if (mimeType.isEmpty()) {
+        static QMimeDatabase mimeDatabase;
+        mimeType = mimeDatabase.mimeTypeForFile(url.path(), QMimeDatabase::MatchExtension).name();
+    }
+
+    GRefPtr<GInputStream> stream;
+    gint64 length = -1;
+    if (auto bytes = mappedBytes(device)) {
+        length = g_bytes_get_size(bytes.get());
+        stream = adoptGRef(g_memory_input_stream_new_from_bytes(bytes.get()));
+    } else {
+        if (!device->isSequential())
+            length = device->size();
+        stream = adoptGRef(wpeqt_io_device_input_stream_new(device.release()));
+    }
+
+    webkit_uri_scheme_request_finish(request, stream.get(), length, mimeType.toUtf8().constData());
+}
+
+static void installScheme(WebKitWebContext* context, const QString& scheme, bool local)
+{
+    const QByteArray name = scheme.toUtf8();
+    webkit_web_context_register_uri_scheme(context, name.constData(), uriSchemeRequestCallback,
+        new QString(scheme), [](gpointer userData) {
+            delete static_cast<QString*>(userData);
+        });
+
+    auto* securityManager = webkit_web_context_get_security_manager(context);
+    webkit_security_manager_register_uri_scheme_as_secure(securityManager, name.constData());
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(securityManager, name.constData());
+    if (local)
+        webkit_security_manager_register_uri_scheme_as_local(securityManager, name.constData());
+}
+
+void WPEQtUriSchemeHandler::installSchemes(WebKitWebContext* context)
+{
+    const auto& registry = schemeRegistry();
+    for (auto it = registry.constBegin(); it != registry.constEnd(); ++it)
+        installScheme(context, it.key(), it.value().local);
+
+    installedContexts().append(context);
+    g_object_weak_ref(G_OBJECT(context), [](gpointer, GObject* context) {
+        installedContexts().removeAll(reinterpret_cast<WebKitWebContext*>(context));
+    }, nullptr);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <QIODevice>
+#include <QString>
+#include <QUrl>
+#include <memory>
+#include <wpe/webkit.h>
+
+class WPEQtUriSchemeHandler {
+public:
+    virtual ~WPEQtUriSchemeHandler() = default;
+
+    // Called on the GUI thread for every request to the scheme. Returns the device
+    // to stream the response from, or nullptr to fail the request as not found.
+    // The MIME type is guessed from the URL when left empty.
+    virtual std::unique_ptr<QIODevice> open(const QUrl&, QString& mimeType) = 0;
+
+    // Registrations apply to every web view, including existing ones.
+    static void registerScheme(const QString& scheme, std::shared_ptr<WPEQtUriSchemeHandler>);
+    static void registerDirectory(const QString& scheme, const QString& rootPath);
+
+    static void installSchemes(WebKitWebContext*);
+};
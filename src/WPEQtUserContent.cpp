@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtUserContent.h"
+
+#include <QFile>
+
+/*!
+  \qmltype WPEUserContent
+  \instantiates WPEQtUserContent
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief The properties shared by WPEUserScript and WPEUserStyleSheet.
+
+  User content is held in the \l WPEProfile and applied by WebKit to the
+  matching pages of every view using the profile, as each document is
+  created, without any round trip through the application.
+
+  URL patterns in \l allowList and \l denyList follow the WebKit syntax, such
+  as \c {https://*.example.com/*}.
+*/
+WPEQtUserContent::WPEQtUserContent(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void WPEQtUserContent::invalidate()
+{
+    clear();
+    Q_EMIT changed();
+}
+
+/*!
+  \qmlproperty string WPEUserContent::source
+
+  The source code of the script or style sheet. It takes precedence over
+  \l sourceUrl.
+*/
+void WPEQtUserContent::setSource(const QString& source)
+{
+    if (source == m_source)
+        return;
+
+    m_source = source;
+    invalidate();
+    Q_EMIT sourceChanged();
+}
+
+/*!
+  \qmlproperty url WPEUserContent::sourceUrl
+
+  The local or \c qrc: URL of a file holding the source code, read when the
+  content is first applied.
+*/
+void WPEQtUserContent::setSourceUrl(const QUrl& sourceUrl)
+{
+    if (sourceUrl == m_sourceUrl)
+        return;
+
+    m_sourceUrl = sourceUrl;
+    invalidate();
+    Q_EMIT sourceUrlChanged();
+}
+
+/*!
+  \qmlproperty bool WPEUserContent::allFrames
+
+  When \c true the content is applied to every frame of the matching pages,
+  otherwise only to their main frame. The default value is \c false.
+*/
+void WPEQtUserContent::setAllFrames(bool allFrames)
+{
+    if (allFrames == m_allFrames)
+        return;
+
+    m_allFrames = allFrames;
+    invalidate();
+    Q_EMIT allFramesChanged();
+}
+
+/*!
+  \qmlproperty list<string> WPEUserContent::allowList
+
+  The URL patterns of the pages the content is applied to. The default, an
+  empty list, matches every page.
+*/
+void WPEQtUserContent::setAllowList(const QStringList& allowList)
+{
+    if (allowList == m_allowList)
+        return;
+
+    m_allowList = allowList;
+    invalidate();
+    Q_EMIT allowListChanged();
+}
+
+/*!
+  \qmlproperty list<string> WPEUserContent::denyList
+
+  The URL patterns of the pages the content is never applied to, even if
+  they match \l allowList.
+*/
+void WPEQtUserContent::setDenyList(const QStringList& denyList)
+{
+    if (denyList == m_denyList)
+        return;
+
+    m_denyList = denyList;
+    invalidate();
+    Q_EMIT denyListChanged();
+}
+
+/*!
+  \qmlproperty string WPEUserContent::worldName
+
+  The name of the script world the content is applied in. Scripts run in a
+  named world share the DOM of the page but not its JavaScript globals,
+  which keeps instrumentation out of reach of the page scripts. The default,
+  an empty string, is the world of the page.
+*/
+void WPEQtUserContent::setWorldName(const QString& worldName)
+{
+    if (worldName == m_worldName)
+        return;
+
+    m_worldName = worldName;
+    invalidate();
+    Q_EMIT worldNameChanged();
+}
+
+bool WPEQtUserContent::prepareArguments(Arguments& arguments) const
+{
+    if (!m_source.isEmpty())
+        arguments.source = m_source.toUtf8();
+    else if (!m_sourceUrl.isEmpty()) {
+        QString path;
+        if (m_sourceUrl.isLocalFile())
+            path = m_sourceUrl.toLocalFile();
+        else if (m_sourceUrl.scheme() == QLatin1String("qrc"))
+            path = QLatin1Char(':') + m_sourceUrl.path();
+
+        QFile file(path);
+        if (path.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+            qWarning("WPEProfile: cannot read user content from %s", qPrintable(m_sourceUrl.toString()));
+            return false;
+        }
+        arguments.source = file.readAll();
+    }
+    if (arguments.source.isEmpty())
+        return false;
+
+    arguments.frames = m_allFrames ? WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES : WEBKIT_USER_CONTENT_INJECT_TOP_FRAME;
+    arguments.worldName = m_worldName.toUtf8();
+
+    // WebKit takes null-terminated arrays of patterns, or null for none.
+    auto toPatterns = [](const QStringList& list, QList<QByteArray>& storage, QVector<const char*>& patterns) {
+        for (const auto& pattern : list)
+            storage.append(pattern.toUtf8());
+        for (const auto& pattern : storage)
+            patterns.append(pattern.constData());
+        if (!patterns.isEmpty())
+            patterns.append(nullptr);
+    };
+    toPatterns(m_allowList, arguments.allowList, arguments.allowPatterns);
+    toPatterns(m_denyList, arguments.denyList, arguments.denyPatterns);
+    return true;
+}
+
+/*!
+  \qmltype WPEUserScript
+  \instantiates WPEQtUserScript
+  \inherits WPEUserContent
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A script injected into the pages of the views using a profile.
+
+  User scripts replace running scripts with
+  \l {WPEView::runJavaScript()}{WPEView.runJavaScript()} once pages are
+  loaded: they are installed once for all the views of a \l WPEProfile and
+  run by WebKit as part of loading each matching document.
+
+  \qml
+  WPEProfile {
+      userScripts: [
+          WPEUserScript {
+              sourceUrl: "qrc:/instrumentation.js"
+              injectionTime: WPEUserScript.DocumentStart
+              worldName: "instrumentation"
+              allowList: [ "https://*.example.com/*" ]
+          }
+      ]
+  }
+  \endqml
+
+  \sa {WPEProfile::userScripts}
+*/
+WPEQtUserScript::WPEQtUserScript(QObject* parent)
+    : WPEQtUserContent(parent)
+{
+}
+
+WPEQtUserScript::~WPEQtUserScript()
+{
+    clear();
+}
+
+/*!
+  \qmlproperty enumeration WPEUserScript::injectionTime
+
+  When the script runs.
+
+  \value WPEUserScript.DocumentStart Before any other content of the document
+         is loaded, when only the document element exists.
+  \value WPEUserScript.DocumentEnd Once the document is parsed, before its
+         subresources finish loading. This is the default.
+*/
+void WPEQtUserScript::setInjectionTime(InjectionTime injectionTime)
+{
+    if (injectionTime == m_injectionTime)
+        return;
+
+    m_injectionTime = injectionTime;
+    invalidate();
+    Q_EMIT injectionTimeChanged();
+}
+
+void WPEQtUserScript::clear()
+{
+    if (m_userScript) {
+        webkit_user_script_unref(m_userScript);
+        m_userScript = nullptr;
+    }
+}
+
+WebKitUserScript* WPEQtUserScript::userScript()
+{
+    if (m_userScript)
+        return m_userScript;
+
+    Arguments arguments;
+    if (!prepareArguments(arguments))
+        return nullptr;
+
+    const auto injectionTime = m_injectionTime == DocumentStart ? WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START : WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_END;
+    const char* const* allowList = arguments.allowPatterns.isEmpty() ? nullptr : arguments.allowPatterns.constData();
+    const char* const* denyList = arguments.denyPatterns.isEmpty() ? nullptr : arguments.denyPatterns.constData();
+    if (arguments.worldName.isEmpty())
+        m_userScript = webkit_user_script_new(arguments.source.constData(), arguments.frames, injectionTime, allowList, denyList);
+    else
+        m_userScript = webkit_user_script_new_for_world(arguments.source.constData(), arguments.frames, injectionTime, arguments.worldName.constData(), allowList, denyList);
+    return m_userScript;
+}
+
+/*!
+  \qmltype WPEUserStyleSheet
+  \instantiates WPEQtUserStyleSheet
+  \inherits WPEUserContent
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief A style sheet applied to the pages of the views using a profile.
+
+  User style sheets are part of the style of each matching document from the
+  start, so they do not cause a restyle or a flash of unstyled content the
+  way style sheets inserted once the page is loaded do.
+
+  \sa {WPEProfile::userStyleSheets}
+*/
+WPEQtUserStyleSheet::WPEQtUserStyleSheet(QObject* parent)
+    : WPEQtUserContent(parent)
+{
+}
+
+WPEQtUserStyleSheet::~WPEQtUserStyleSheet()
+{
+    clear();
+}
+
+/*!
+  \qmlproperty enumeration WPEUserStyleSheet::level
+
+  How the style sheet cascades with the style sheets of the page.
+
+  \value WPEUserStyleSheet.UserLevel The style sheet is a user style sheet,
+         which page style sheets override unless its rules are
+         \c {!important}. This is the default.
+  \value WPEUserStyleSheet.AuthorLevel The style sheet is considered as one
+         of the page, and takes part in the cascade like them.
+*/
+void WPEQtUserStyleSheet::setLevel(Level level)
+{
+    if (level == m_level)
+        return;
+
+    m_level = level;
+    invalidate();
+    Q_EMIT levelChanged();
+}
+
+void WPEQtUserStyleSheet::clear()
+{
+    if (m_userStyleSheet) {
+        webkit_user_style_sheet_unref(m_userStyleSheet);
+        m_userStyleSheet = nullptr;
+    }
+}
+
+WebKitUserStyleSheet* WPEQtUserStyleSheet::userStyleSheet()
+{
+    if (m_userStyleSheet)
+        return m_userStyleSheet;
+
+    Arguments arguments;
+    if (!prepareArguments(arguments))
+        return nullptr;
+
+    const auto level = m_level == UserLevel ? WEBKIT_USER_STYLE_LEVEL_USER : WEBKIT_USER_STYLE_LEVEL_AUTHOR;
+    const char* const* allowList = arguments.allowPatterns.isEmpty() ? nullptr : arguments.allowPatterns.constData();
+    const char* const* denyList = arguments.denyPatterns.isEmpty() ? nullptr : arguments.denyPatterns.constData();
+    if (arguments.worldName.isEmpty())
+        m_userStyleSheet = webkit_user_style_sheet_new(arguments.source.constData(), arguments.frames, level, allowList, denyList);
+    else
+        m_userStyleSheet = webkit_user_style_sheet_new_for_world(arguments.source.constData(), arguments.frames, level, arguments.worldName.constData(), allowList, denyList);
+    return m_userStyleSheet;
+}
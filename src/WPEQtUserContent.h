@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+#include <QVector>
+#include <wpe/webkit.h>
+
+// Shared part of the user scripts and style sheets of a WPEQtProfile. The
+// WebKit objects are built on first use and kept until a property changes,
+// so every view and every page reuses the same ones.
+class WPEQtUserContent : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtUserContent)
+    Q_PROPERTY(QString source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QUrl sourceUrl READ sourceUrl WRITE setSourceUrl NOTIFY sourceUrlChanged)
+    Q_PROPERTY(bool allFrames READ allFrames WRITE setAllFrames NOTIFY allFramesChanged)
+    Q_PROPERTY(QStringList allowList READ allowList WRITE setAllowList NOTIFY allowListChanged)
+    Q_PROPERTY(QStringList denyList READ denyList WRITE setDenyList NOTIFY denyListChanged)
+    Q_PROPERTY(QString worldName READ worldName WRITE setWorldName NOTIFY worldNameChanged)
+
+public:
+    QString source() const { return m_source; };
+    void setSource(const QString&);
+    QUrl sourceUrl() const { return m_sourceUrl; };
+    void setSourceUrl(const QUrl&);
+    bool allFrames() const { return m_allFrames; };
+    void setAllFrames(bool);
+    QStringList allowList() const { return m_allowList; };
+    void setAllowList(const QStringList&);
+    QStringList denyList() const { return m_denyList; };
+    void setDenyList(const QStringList&);
+    QString worldName() const { return m_worldName; };
+    void setWorldName(const QString&);
+
+Q_SIGNALS:
+    void sourceChanged();
+    void sourceUrlChanged();
+    void allFramesChanged();
+    void allowListChanged();
+    void denyListChanged();
+    void worldNameChanged();
+    void changed();
+
+protected:
+    explicit WPEQtUserContent(QObject* parent);
+
+    // Arguments shared by the WebKit constructors, valid until the next call.
+    struct Arguments {
+        QByteArray source;
+        WebKitUserContentInjectedFrames frames;
+        QByteArray worldName;
+        QList<QByteArray> allowList;
+        QList<QByteArray> denyList;
+        QVector<const char*> allowPatterns;
+        QVector<const char*> denyPatterns;
+    };
+    bool prepareArguments(Arguments&) const;
+    void invalidate();
+
+    virtual void clear() = 0;
+
+private:
+    QString m_source;
+    QUrl m_sourceUrl;
+    bool m_allFrames { false };
+    QStringList m_allowList;
+    QStringList m_denyList;
+    QString m_worldName;
+};
+
+class WPEQtUserScript : public WPEQtUserContent {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtUserScript)
+    Q_PROPERTY(InjectionTime injectionTime READ injectionTime WRITE setInjectionTime NOTIFY injectionTimeChanged)
+    Q_ENUMS(InjectionTime)
+
+public:
+    enum InjectionTime {
+        DocumentStart,
+        DocumentEnd
+    };
+
+    explicit WPEQtUserScript(QObject* parent = nullptr);
+    ~WPEQtUserScript();
+
+    InjectionTime injectionTime() const { return m_injectionTime; };
+    void setInjectionTime(InjectionTime);
+
+    WebKitUserScript* userScript();
+
+Q_SIGNALS:
+    void injectionTimeChanged();
+
+protected:
+    void clear() override;
+
+private:
+    InjectionTime m_injectionTime { DocumentEnd };
+    WebKitUserScript* m_userScript { nullptr };
+};
+
+class WPEQtUserStyleSheet : public WPEQtUserContent {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtUserStyleSheet)
+    Q_PROPERTY(Level level READ level WRITE setLevel NOTIFY levelChanged)
+    Q_ENUMS(Level)
+
+public:
+    enum Level {
+        UserLevel,
+        AuthorLevel
+    };
+
+    explicit WPEQtUserStyleSheet(QObject* parent = nullptr);
+    ~WPEQtUserStyleSheet();
+
+    Level level() const { return m_level; };
+    void setLevel(Level);
+
+    WebKitUserStyleSheet* userStyleSheet();
+
+Q_SIGNALS:
+    void levelChanged();
+
+protected:
+    void clear() override;
+
+private:
+    Level m_level { UserLevel };
+    WebKitUserStyleSheet* m_userStyleSheet { nullptr };
+};
@@ -24,12 +24,25 @@
 #include "WPEQtViewBackend.h"
 #include "WPEQtViewLoadRequest.h"
 #include "WPEQtViewLoadRequestPrivate.h"
+#include "WPEQtGeolocation.h"
 #include "WPEQtImContext.h"
+#include "WPEQtLoadScheduler.h"
+#include "WPEQtNewViewRequest.h"
+#include "WPEQtPermissionRequest.h"
+#include "WPEQtProcessMonitor.h"
+#include "WPEQtProfile.h"
+#include "WPEQtResourceTrace.h"
+#include <QDataStream>
 #include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaMethod>
 #include <QQuickWindow>
 #include <QSGSimpleTextureNode>
 #include <QScreen>
+#include <QStyleHints>
 #include <QtGlobal>
+#include <algorithm>
 #include <qpa/qplatformnativeinterface.h>
 #include <wtf/glib/GUniquePtr.h>
 
@@ -50,6 +63,27 @@ WPEQtView::WPEQtView(QQuickItem* parent)
     : QQuickItem(parent)
 {
     connect(this, &QQuickItem::windowChanged, this, &WPEQtView::configureWindow);
+    connect(this, &QQuickItem::visibleChanged, this, &WPEQtView::maybeCreateWebView);
+    connect(this, &QQuickItem::visibleChanged, this, &WPEQtView::updateEffectivePriority);
+    connect(this, &QQuickItem::activeFocusChanged, this, &WPEQtView::updateEffectivePriority);
+    connect(this, &QQuickItem::visibleChanged, this, [this] {
+        if (m_backend && !isVisible())
+            m_backend->cancelSnapshots();
+    });
+    m_recoveryTimer.setSingleShot(true);
+    connect(&m_recoveryTimer, &QTimer::timeout, this, &WPEQtView::recoverWebProcess);
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(100);
+    connect(&m_prefetchTimer, &QTimer::timeout, this, [this] {
+        prefetch(m_prefetchCandidate);
+    });
+    m_longPressTimer.setSingleShot(true);
+    connect(&m_longPressTimer, &QTimer::timeout, this, [this] {
+        prefetchLinkAt(m_longPressPosition);
+    });
+    m_findTimer.setSingleShot(true);
+    m_findTimer.setInterval(150);
+    connect(&m_findTimer, &QTimer::timeout, this, &WPEQtView::search);
     setFlag(ItemHasContents, true);
     setAcceptedMouseButtons(Qt::AllButtons);
     setAcceptHoverEvents(true);
@@ -58,6 +92,14 @@ WPEQtView::WPEQtView(QQuickItem* parent)
 
 WPEQtView::~WPEQtView()
 {
+    stopLocationServices();
+
+    if (!m_webView)
+        return;
+
+    m_resourceTrace = nullptr;
+    WPEQtLoadScheduler::singleton()->cancel(this);
+    WPEQtProcessMonitor::singleton()->unregisterView(this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyUrlChangedCallback), this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyTitleChangedCallback), this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyLoadChangedCallback), this);
@@ -67,9 +109,11 @@ WPEQtView::~WPEQtView()
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyWebProcessTerminatedCallback), this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyRunFileChooserCallback), this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyPermissionRequestCallback), this);
-    g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyLocationManagerStart), this);
-    g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyLocationManagerStop), this);
     g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(createRequested), this);
+    g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(notifyCloseCallback), this);
+    g_signal_handlers_disconnect_by_func(m_webView.get(), reinterpret_cast<gpointer>(mouseTargetChangedCallback), this);
+    g_signal_handlers_disconnect_by_func(webkit_web_view_get_find_controller(m_webView.get()), reinterpret_cast<gpointer>(foundTextCallback), this);
+    g_signal_handlers_disconnect_by_func(webkit_web_view_get_find_controller(m_webView.get()), reinterpret_cast<gpointer>(failedToFindTextCallback), this);
 
     webkit_web_view_terminate_web_process(m_webView.get());
 }
@@ -83,6 +127,8 @@ void WPEQtView::geometryChanged(const QRectF& newGeometry, const QRectF&)
     m_size = newGeometry.size();
     if (m_backend)
         m_backend->resize(newGeometry.size());
+    else
+        maybeCreateWebView();
 }
 
 void WPEQtView::configureWindow()
@@ -94,9 +140,41 @@ void WPEQtView::configureWindow()
     win->setSurfaceType(QWindow::OpenGLSurface);
 
     if (win->isSceneGraphInitialized())
-        createWebView();
+        maybeCreateWebView();
     else
-        connect(win, &QQuickWindow::sceneGraphInitialized, this, &WPEQtView::createWebView);
+        connect(win, &QQuickWindow::sceneGraphInitialized, this, &WPEQtView::maybeCreateWebView);
+}
+
+void WPEQtView::componentComplete()
+{
+    QQuickItem::componentComplete();
+    maybeCreateWebView();
+}
+
+void WPEQtView::maybeCreateWebView()
+{
+    // Wait for QML to apply the bindings, such as createPolicy and profile.
+    if (m_backend || !isComponentComplete())
+        return;
+
+    auto* win = window();
+    if (!win || !win->isSceneGraphInitialized())
+        return;
+
+    switch (m_createPolicy) {
+    case Immediate:
+        break;
+    case OnFirstVisible:
+        if (!m_createRequested && (!isVisible() || m_size.isEmpty()))
+            return;
+        break;
+    case OnDemand:
+        if (!m_createRequested)
+            return;
+        break;
+    }
+
+    createWebView();
 }
 
 static QOpenGLContext *glContext(QQuickWindow *window)
@@ -112,6 +190,11 @@ static QOpenGLContext *glContext(QQuickWindow *window)
 }
 
 void WPEQtView::createWebView()
+{
+    createWebView(nullptr);
+}
+
+void WPEQtView::createWebView(WebKitWebView* relatedView)
 {
     if (m_backend)
         return;
@@ -123,24 +206,10 @@ void WPEQtView::createWebView()
     if (!backend)
         return;
 
-    const auto appName = QGuiApplication::applicationName();
-    const auto dataHome = QString::fromUtf8(qgetenv("XDG_DATA_HOME"));
-    const auto cacheHome = QString::fromUtf8(qgetenv("XDG_CACHE_HOME"));
-
-    const auto cacheDirRoot = QStringLiteral("%1/%2").arg(cacheHome, appName);
-    const auto dataDirRoot = QStringLiteral("%1/%2/data").arg(dataHome, appName);
-    const auto extensionsDirRoot = QStringLiteral("%1/%2/extensions").arg(dataHome, appName);
-    const auto cookiesFile = QStringLiteral("%1/%2/cookies.sqlite").arg(dataHome, appName);
-
-    m_networkSession = adoptGRef(webkit_network_session_new(dataDirRoot.toStdString().c_str(), cacheDirRoot.toStdString().c_str()));
-    m_webContext = adoptGRef(webkit_web_context_new());
-
-    webkit_network_session_set_persistent_credential_storage_enabled(m_networkSession.get(), TRUE);
-
-    auto* cookieManager = webkit_network_session_get_cookie_manager(m_networkSession.get());
-    webkit_cookie_manager_set_persistent_storage(cookieManager, cookiesFile.toStdString().c_str(), WEBKIT_COOKIE_PERSISTENT_STORAGE_SQLITE);
-
-    webkit_web_context_set_web_process_extensions_directory(m_webContext.get(), extensionsDirRoot.toStdString().c_str());
+    if (!m_profile)
+        m_profile = WPEQtProfile::defaultProfile();
+    m_networkSession = m_profile->networkSession();
+    m_webContext = m_profile->webContext();
 
     const auto userAgent = QStringLiteral("Mozilla/5.0 (X11; Ubuntu; Linux) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/17.5 Safari/605.1.15 (like iPhone OS)");
 
@@ -166,6 +235,8 @@ void WPEQtView::createWebView()
         "settings", settings.get(),
         "network-session", m_networkSession.get(),
         "web-context", m_webContext.get(),
+        "user-content-manager", m_profile->userContentManager(),
+        "related-view", relatedView,
         nullptr)));
 
     m_backend->setScaleFactor(window()->devicePixelRatio());
@@ -180,60 +251,276 @@ void WPEQtView::createWebView()
     g_signal_connect(m_webView.get(), "load-changed", G_CALLBACK(notifyLoadChangedCallback), this);
     g_signal_connect(m_webView.get(), "load-failed", G_CALLBACK(notifyLoadFailedCallback), this);
     g_signal_connect(m_webView.get(), "create", G_CALLBACK(createRequested), this);
+    g_signal_connect(m_webView.get(), "close", G_CALLBACK(notifyCloseCallback), this);
+    g_signal_connect(m_webView.get(), "mouse-target-changed", G_CALLBACK(mouseTargetChangedCallback), this);
     g_signal_connect(m_webView.get(), "web-process-terminated", G_CALLBACK(notifyWebProcessTerminatedCallback), this);
     g_signal_connect(m_webView.get(), "run-file-chooser", G_CALLBACK(notifyRunFileChooserCallback), this);
+    g_signal_connect(webkit_web_view_get_find_controller(m_webView.get()), "found-text", G_CALLBACK(foundTextCallback), this);
+    g_signal_connect(webkit_web_view_get_find_controller(m_webView.get()), "failed-to-find-text", G_CALLBACK(failedToFindTextCallback), this);
 
     g_signal_connect(m_webView.get(), "permission-request", G_CALLBACK(notifyPermissionRequestCallback), this);
+    if (m_resourceTraceSize > 0)
+        m_resourceTrace = std::make_unique<WPEQtResourceTrace>(m_webView.get(), m_resourceTraceSize);
 
-    m_locationManager = webkit_web_context_get_geolocation_manager(m_webContext.get());
-    g_signal_connect(m_locationManager, "start", G_CALLBACK(notifyLocationManagerStart), this);
-    g_signal_connect(m_locationManager, "stop", G_CALLBACK(notifyLocationManagerStop), this);
+    WPEQtProcessMonitor::singleton()->registerView(this);
+    WPEQtGeolocation::singleton()->addManager(webkit_web_context_get_geolocation_manager(m_webContext.get()));
 
-    if (!m_url.isEmpty())
+    // Related views are loaded by WebKit once returned from the "create" signal.
+    if (!relatedView)
+        WPEQtLoadScheduler::singleton()->schedule(this);
+
+    const auto pendingJavaScript = std::move(m_pendingJavaScript);
+    m_pendingJavaScript.clear();
+    for (const auto& call : pendingJavaScript)
+        runJavaScript(call.first, call.second);
+
+    Q_EMIT webViewCreated();
+}
+
+bool WPEQtView::loadInitialContent()
+{
+    if (!m_pendingSessionState.isEmpty()) {
+        const QByteArray state = std::move(m_pendingSessionState);
+        m_pendingSessionState.clear();
+        if (restoreState(state))
+            return true;
+    }
+
+    if (!m_url.isEmpty()) {
         webkit_web_view_load_uri(m_webView.get(), m_url.toString().toUtf8().constData());
-    else if (!m_html.isEmpty())
+        return true;
+    }
+    if (!m_html.isEmpty()) {
         webkit_web_view_load_html(m_webView.get(), m_html.toUtf8().constData(), m_baseUrl.toString().toUtf8().constData());
+        return true;
+    }
+    return false;
+}
 
-    Q_EMIT webViewCreated();
+// Views with the default priority are admitted by WPELoadScheduler as if
+// their priority was automatic.
+WPEQtView::Priority WPEQtView::loadPriority() const
+{
+    if (m_priority != NormalPriority)
+        return m_effectivePriority;
+    if (hasActiveFocus())
+        return ForegroundPriority;
+    return isVisible() ? NormalPriority : BackgroundPriority;
 }
 
 void WPEQtView::notifyUrlChangedCallback(WPEQtView* view)
 {
-    Q_EMIT view->urlChanged();
+    view->queueNotification(UrlNotification);
 }
 
 void WPEQtView::notifyTitleChangedCallback(WPEQtView* view)
 {
-    Q_EMIT view->titleChanged();
+    view->queueNotification(TitleNotification);
 }
 
 void WPEQtView::notifyLoadProgressCallback(WPEQtView* view)
 {
-    Q_EMIT view->loadProgressChanged();
+    view->queueNotification(LoadProgressNotification);
+}
+
+void WPEQtView::queueNotification(PendingNotification notification)
+{
+    m_pendingNotifications |= notification;
+    if (!m_batchedSignals) {
+        flushPendingNotifications();
+        return;
+    }
+
+    // Only one queued flush is in flight per batch, so a burst of WebKit
+    // notifications costs a single event loop round-trip.
+    if (m_notificationFlushScheduled)
+        return;
+
+    m_notificationFlushScheduled = true;
+    QMetaObject::invokeMethod(this, "flushPendingNotifications", Qt::QueuedConnection);
+}
+
+void WPEQtView::flushPendingNotifications()
+{
+    m_notificationFlushScheduled = false;
+    const unsigned pending = m_pendingNotifications;
+    m_pendingNotifications = 0;
+
+    if (pending & UrlNotification)
+        Q_EMIT urlChanged();
+    if (pending & TitleNotification)
+        Q_EMIT titleChanged();
+    if (pending & LoadProgressNotification)
+        Q_EMIT loadProgressChanged();
+    if (pending & ThemeColorNotification)
+        Q_EMIT themeColorChanged();
+}
+
+WPEQtViewLoadRequest* WPEQtView::beginLoadRequest(const QUrl& url)
+{
+    m_currentLoadRequest = (m_currentLoadRequest + 1) % m_loadRequests.size();
+    auto& loadRequest = m_loadRequests[m_currentLoadRequest];
+    if (!loadRequest) {
+        loadRequest = std::make_unique<WPEQtViewLoadRequest>(WPEQtViewLoadRequestPrivate());
+        QQmlEngine::setObjectOwnership(loadRequest.get(), QQmlEngine::CppOwnership);
+    }
+    loadRequest->d_func()->reset(++m_navigationId, url);
+    return loadRequest.get();
+}
+
+WPEQtViewLoadRequest* WPEQtView::currentLoadRequest()
+{
+    if (!m_loadRequests[m_currentLoadRequest])
+        return beginLoadRequest(url());
+    return m_loadRequests[m_currentLoadRequest].get();
+}
+
+void WPEQtView::updateLoadRequest(WPEQtViewLoadRequest* loadRequest)
+{
+    Q_EMIT loadRequest->updated();
+}
+
+void WPEQtView::didDisplayFrame()
+{
+    if (!m_awaitingFirstFrame)
+        return;
+
+    m_awaitingFirstFrame = false;
+    auto* loadRequest = currentLoadRequest();
+    loadRequest->d_func()->m_firstVisuallyNonEmptyTime = WPEQtViewLoadRequest::monotonicTime();
+    updateLoadRequest(loadRequest);
+}
+
+struct NavigationTimingData {
+    QPointer<WPEQtViewLoadRequest> loadRequest;
+    quint64 navigationId;
+};
+
+void WPEQtView::navigationTimingReadyCallback(GObject* object, GAsyncResult* result, gpointer userData)
+{
+    std::unique_ptr<NavigationTimingData> data(static_cast<NavigationTimingData*>(userData));
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    GRefPtr<JSCValue> value = adoptGRef(webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(object), result, nullptr));
+    if (!value || !jsc_value_is_string(value.get()))
+        return;
+    GUniquePtr<gchar> json(jsc_value_to_string(value.get()));
+#else
+    WebKitJavascriptResult* jsResult = webkit_web_view_run_javascript_in_world_finish(WEBKIT_WEB_VIEW(object), result, nullptr);
+    if (!jsResult)
+        return;
+    JSCValue* value = webkit_javascript_result_get_js_value(jsResult);
+    GUniquePtr<gchar> json(jsc_value_is_string(value) ? jsc_value_to_string(value) : nullptr);
+    webkit_javascript_result_unref(jsResult);
+    if (!json)
+        return;
+#endif
+
+    if (!data->loadRequest)
+        return;
+
+    auto* d = data->loadRequest->d_func();
+    if (d->m_navigationId != data->navigationId)
+        return;
+
+    d->m_navigationTiming = QJsonDocument::fromJson(QByteArray(json.get())).object().toVariantMap();
+    Q_EMIT data->loadRequest->updated();
+}
+
+void WPEQtView::collectNavigationTiming()
+{
+    static const char script[] =
+        "(function() {"
+        "    var entry = performance.getEntriesByType('navigation')[0];"
+        "    return JSON.stringify(entry ? entry.toJSON() : performance.timing.toJSON());"
+        "})()";
+
+    // Read from an isolated world, where the page cannot replace performance.
+    auto* loadRequest = currentLoadRequest();
+    auto* data = new NavigationTimingData { loadRequest, loadRequest->d_func()->m_navigationId };
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    webkit_web_view_evaluate_javascript(m_webView.get(), script, -1, "wpeqt-navigation-timing", nullptr, nullptr, navigationTimingReadyCallback, data);
+#else
+    webkit_web_view_run_javascript_in_world(m_webView.get(), script, "wpeqt-navigation-timing", nullptr, navigationTimingReadyCallback, data);
+#endif
+}
+
+// Asked on every commit, as a navigation may swap the web process of the view.
+void WPEQtView::requestWebProcessIdentifier()
+{
+    webkit_web_view_send_message_to_page(m_webView.get(), webkit_user_message_new("wpeqt-get-process-id", nullptr), nullptr,
+        webProcessIdentifierCallback, new QPointer<WPEQtView>(this));
+}
+
+void WPEQtView::webProcessIdentifierCallback(GObject* object, GAsyncResult* result, gpointer userData)
+{
+    std::unique_ptr<QPointer<WPEQtView>> view(static_cast<QPointer<WPEQtView>*>(userData));
+
+    // Fails when the web process extension of the plugin is not installed.
+    GRefPtr<WebKitUserMessage> reply = adoptGRef(webkit_web_view_send_message_to_page_finish(WEBKIT_WEB_VIEW(object), result, nullptr));
+    if (!reply || !*view)
+        return;
+
+    GVariant* parameters = webkit_user_message_get_parameters(reply.get());
+    if (!parameters || !g_variant_is_of_type(parameters, G_VARIANT_TYPE("(xt)")))
+        return;
+
+    gint64 pid;
+    guint64 pidNamespace;
+    g_variant_get(parameters, "(xt)", &pid, &pidNamespace);
+    WPEQtProcessMonitor::singleton()->setViewProcess(*view, pid, pidNamespace);
 }
 
 void WPEQtView::notifyLoadChangedCallback(WebKitWebView*, WebKitLoadEvent event, WPEQtView* view)
 {
+    const qreal now = WPEQtViewLoadRequest::monotonicTime();
+    WPEQtViewLoadRequest* loadRequest = nullptr;
     bool statusSet = false;
-    WPEQtView::LoadStatus loadStatus;
     switch (event) {
     case WEBKIT_LOAD_STARTED:
-        loadStatus = WPEQtView::LoadStatus::LoadStartedStatus;
+        loadRequest = view->beginLoadRequest(view->url());
+        loadRequest->d_func()->m_startedTime = now;
+        view->m_awaitingFirstFrame = false;
         statusSet = true;
         break;
+    case WEBKIT_LOAD_REDIRECTED: {
+        loadRequest = view->currentLoadRequest();
+        auto* d = loadRequest->d_func();
+        d->m_url = view->url();
+        d->m_redirectedTime = now;
+        d->m_redirectCount++;
+        view->updateLoadRequest(loadRequest);
+        break;
+    }
+    case WEBKIT_LOAD_COMMITTED:
+        loadRequest = view->currentLoadRequest();
+        loadRequest->d_func()->m_url = view->url();
+        loadRequest->d_func()->m_committedTime = now;
+        view->m_awaitingFirstFrame = true;
+        view->m_committedUrl = view->url();
+        view->m_searchedText.clear();
+        view->profile()->noteOriginUsed(view->url());
+        view->requestWebProcessIdentifier();
+        view->updateLoadRequest(loadRequest);
+        break;
     case WEBKIT_LOAD_FINISHED:
-        loadStatus = WPEQtView::LoadStatus::LoadSucceededStatus;
-        statusSet = !view->errorOccured();
+        loadRequest = view->currentLoadRequest();
+        if (loadRequest->d_func()->m_finishedTime < 0)
+            loadRequest->d_func()->m_finishedTime = now;
+        if (!view->errorOccured()) {
+            loadRequest->d_func()->m_status = WPEQtView::LoadStatus::LoadSucceededStatus;
+            statusSet = true;
+            view->collectNavigationTiming();
+        }
         view->setErrorOccured(false);
+        WPEQtLoadScheduler::singleton()->finished(view);
         break;
     default:
         break;
     }
 
     if (statusSet) {
-        WPEQtViewLoadRequestPrivate loadRequestPrivate(view->url(), loadStatus, "");
-        std::unique_ptr<WPEQtViewLoadRequest> loadRequest = std::make_unique<WPEQtViewLoadRequest>(loadRequestPrivate);
-        Q_EMIT view->loadingChanged(loadRequest.get());
+        view->flushPendingNotifications();
+        Q_EMIT view->loadingChanged(loadRequest);
     }
 }
 
@@ -241,49 +528,135 @@ void WPEQtView::notifyLoadFailedCallback(WebKitWebView*, WebKitLoadEvent, const
 {
     view->setErrorOccured(true);
 
-    WPEQtView::LoadStatus loadStatus;
+    auto* loadRequest = view->currentLoadRequest();
+    auto* d = loadRequest->d_func();
     if (g_error_matches(error, WEBKIT_NETWORK_ERROR, WEBKIT_NETWORK_ERROR_CANCELLED))
-        loadStatus = WPEQtView::LoadStatus::LoadStoppedStatus;
+        d->m_status = WPEQtView::LoadStatus::LoadStoppedStatus;
     else
-        loadStatus = WPEQtView::LoadStatus::LoadFailedStatus;
+        d->m_status = WPEQtView::LoadStatus::LoadFailedStatus;
+    d->m_url = QUrl(QString(failingURI));
+    d->m_errorString = QString::fromUtf8(error->message);
+    d->m_finishedTime = WPEQtViewLoadRequest::monotonicTime();
 
-    WPEQtViewLoadRequestPrivate loadRequestPrivate(QUrl(QString(failingURI)), loadStatus, error->message);
-    std::unique_ptr<WPEQtViewLoadRequest> loadRequest = std::make_unique<WPEQtViewLoadRequest>(loadRequestPrivate);
-    Q_EMIT view->loadingChanged(loadRequest.get());
+    view->flushPendingNotifications();
+    Q_EMIT view->loadingChanged(loadRequest);
 }
 
 void WPEQtView::notifyThemeColorChangedCallback(WPEQtView* view)
 {
-    qDebug() << Q_FUNC_INFO << "";
-    Q_EMIT view->themeColorChanged();
+    view->queueNotification(ThemeColorNotification);
 }
 
-void WPEQtView::notifyWebProcessTerminatedCallback(WebKitWebView*, WebKitWebProcessTerminationReason, WPEQtView* view)
+void WPEQtView::notifyWebProcessTerminatedCallback(WebKitWebView*, WebKitWebProcessTerminationReason reason, WPEQtView* view)
 {
-    Q_EMIT view->webProcessCrashed();
-}
+    WPEQtProcessMonitor::singleton()->webProcessTerminated(view);
+    WPEQtLoadScheduler::singleton()->finished(view);
+    if (view->m_backend) {
+        view->m_backend->discardFrames();
+        view->update();
+    }
+    view->m_awaitingFirstFrame = false;
+    view->m_committedUrl = QUrl();
+
+    TerminationReason terminationReason;
+    switch (reason) {
+    case WEBKIT_WEB_PROCESS_EXCEEDED_MEMORY_LIMIT:
+        terminationReason = MemoryLimitTermination;
+        view->m_memoryLimitTerminationCount++;
+        break;
+    case WEBKIT_WEB_PROCESS_TERMINATED_BY_API:
+        terminationReason = RequestedTermination;
+        break;
+    case WEBKIT_WEB_PROCESS_CRASHED:
+    default:
+        terminationReason = CrashedTermination;
+        view->m_crashCount++;
+        break;
+    }
 
-void WPEQtView::notifyRunFileChooserCallback(WebKitWebView*, WebKitFileChooserRequest* request, WPEQtView* view)
-{
-    view->makeFileChooserRequest(request);
+    if (terminationReason != RequestedTermination) {
+        Q_EMIT view->crashCountChanged();
+        Q_EMIT view->webProcessCrashed();
+    }
+    Q_EMIT view->webProcessTerminated(terminationReason);
+
+    if (!view->m_crashRecovery || terminationReason == RequestedTermination)
+        return;
+
+    // A process that stayed alive long enough is considered recovered,
+    // later terminations start over with the shortest delay.
+    static const qint64 stableProcessInterval = 60000;
+    if (view->m_sinceLastRecovery.isValid() && view->m_sinceLastRecovery.elapsed() > stableProcessInterval)
+        view->m_recoveryAttempts = 0;
+
+    if (view->m_recoveryAttempts >= view->m_maxRecoveryAttempts) {
+        Q_EMIT view->webProcessRecoveryFailed();
+        return;
+    }
+
+    // The back/forward list lives in the UI process, so it survives the
+    // web process and its current item is the last committed page.
+    view->m_recoveryState = view->saveState();
+
+    static const int initialRecoveryDelay = 500;
+    static const int maximumRecoveryDelay = 30000;
+    const int delay = std::min(initialRecoveryDelay << std::min(view->m_recoveryAttempts, 16), maximumRecoveryDelay);
+    view->m_recoveryAttempts++;
+    Q_EMIT view->webProcessRecovering(view->m_recoveryAttempts, delay);
+    view->m_recoveryTimer.start(delay);
 }
 
-void WPEQtView::notifyPermissionRequestCallback(WebKitWebView *web_view, WebKitPermissionRequest *request, WPEQtView* view)
+void WPEQtView::recoverWebProcess()
 {
-    if (!request)
+    if (!m_webView)
         return;
 
-    webkit_permission_request_allow(request);
+    m_sinceLastRecovery.start();
+    const QByteArray state = std::move(m_recoveryState);
+    m_recoveryState.clear();
+    if (restoreState(state))
+        return;
+
+    if (!m_url.isEmpty())
+        webkit_web_view_load_uri(m_webView.get(), m_url.toString().toUtf8().constData());
+    else
+        webkit_web_view_reload(m_webView.get());
 }
 
-void WPEQtView::notifyLocationManagerStart(WebKitWebView*, WebKitGeolocationManager* manager, WPEQtView* view)
+void WPEQtView::notifyRunFileChooserCallback(WebKitWebView*, WebKitFileChooserRequest* request, WPEQtView* view)
 {
-    view->startLocationServices();
+    view->makeFileChooserRequest(request);
 }
 
-void WPEQtView::notifyLocationManagerStop(WebKitWebView*, WebKitGeolocationManager* manager, WPEQtView* view)
+gboolean WPEQtView::notifyPermissionRequestCallback(WebKitWebView*, WebKitPermissionRequest* request, WPEQtView* view)
 {
-    view->stopLocationServices();
+    // WebKit does not expose the origin of the requesting frame. Frames only
+    // get permissions delegated by the page, so use the origin of the committed
+    // page: url() may already be the one of a provisional navigation. Without a
+    // committed page, the request is neither matched nor remembered.
+    const QString origin = view->m_committedUrl.isEmpty() ? QString() : WPEQtProfile::permissionOrigin(view->m_committedUrl);
+    const int types = WPEQtPermissionRequest::permissionTypes(request);
+    switch (origin.isEmpty() ? WPEQtProfile::AskPermission : view->profile()->permission(origin, types)) {
+    case WPEQtProfile::AllowPermission:
+        webkit_permission_request_allow(request);
+        return TRUE;
+    case WPEQtProfile::DenyPermission:
+        webkit_permission_request_deny(request);
+        return TRUE;
+    case WPEQtProfile::AskPermission:
+        break;
+    }
+
+    if (!view->isSignalConnected(QMetaMethod::fromSignal(&WPEQtView::permissionRequested))) {
+        webkit_permission_request_deny(request);
+        return TRUE;
+    }
+
+    // Parented to the view so that requests left unanswered are denied with it.
+    auto* permissionRequest = new WPEQtPermissionRequest(request, origin, types, view->profile(), view);
+    QQmlEngine::setObjectOwnership(permissionRequest, QQmlEngine::CppOwnership);
+    Q_EMIT view->permissionRequested(permissionRequest);
+    return TRUE;
 }
 
 void WPEQtView::makeFileChooserRequest(WebKitFileChooserRequest* request)
@@ -345,17 +718,66 @@ void WPEQtView::cancelFileSelection()
     m_currentFileChooserRequest = nullptr;
 }
 
-void *WPEQtView::createRequested(WebKitWebView* web_view, WebKitNavigationAction* action, WPEQtView*)
+WebKitWebView* WPEQtView::createRelatedWebView(WPEQtView* opener)
+{
+    if (m_backend)
+        return nullptr;
+
+    auto* win = window();
+    if (!win || !win->isSceneGraphInitialized())
+        return nullptr;
+
+    // Related views share the web process, hence the web context, of the opener.
+    if (m_profile != opener->profile()) {
+        m_profile = opener->profile();
+        Q_EMIT profileChanged();
+    }
+
+    m_createRequested = true;
+    createWebView(opener->m_webView.get());
+    return m_webView.get();
+}
+
+WebKitWebView* WPEQtView::createRequested(WebKitWebView* webView, WebKitNavigationAction* action, WPEQtView* view)
 {
-    webkit_web_view_load_request(web_view, webkit_navigation_action_get_request(action));
+    auto* request = webkit_navigation_action_get_request(action);
+    const QUrl url(QString::fromUtf8(webkit_uri_request_get_uri(request)));
+
+    WPEQtNewViewRequest newViewRequest(url, webkit_navigation_action_is_user_gesture(action));
+    QQmlEngine::setObjectOwnership(&newViewRequest, QQmlEngine::CppOwnership);
+    Q_EMIT view->newViewRequested(&newViewRequest);
+
+    auto* newView = newViewRequest.view();
+    if (newView && newView != view) {
+        if (auto* newWebView = newView->createRelatedWebView(view))
+            return newWebView;
+
+        qWarning("WPEView: the view supplied for a new view request cannot be created now, loading %s without opener",
+            qUtf8Printable(url.toString()));
+        newView->setUrl(url);
+        return nullptr;
+    }
+
+    // Nobody supplied a view, load the request in place of the opener.
+    webkit_web_view_load_request(webView, request);
     return nullptr;
 }
 
+void WPEQtView::notifyCloseCallback(WebKitWebView*, WPEQtView* view)
+{
+    Q_EMIT view->closeRequested();
+}
+
 QSGNode* WPEQtView::updatePaintNode(QSGNode* node, UpdatePaintNodeData*)
 {
     if (!m_webView || !m_backend)
         return node;
 
+    if (!m_backend->hasFrame()) {
+        delete node;
+        return nullptr;
+    }
+
     auto* textureNode = static_cast<QSGSimpleTextureNode*>(node);
     if (!textureNode)
         textureNode = new QSGSimpleTextureNode();
@@ -364,6 +786,8 @@ QSGNode* WPEQtView::updatePaintNode(QSGNode* node, UpdatePaintNodeData*)
     if (!textureId)
         return node;
 
+    m_backend->processSnapshots(glContext(window()));
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QSGTexture *texture = QNativeInterface::QSGOpenGLTexture::fromNative(textureId, window(), m_size.toSize(), QQuickWindow::TextureHasAlphaChannel);
 #elif (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
@@ -394,7 +818,9 @@ QUrl WPEQtView::url() const
   The URL is used as-is. URLs that originate from user input should
   be parsed with QUrl::fromUserInput().
 
-  \note The WPEView does not support loading content through the Qt Resource system.
+  Content from the Qt Resource system can be loaded with \c qrc: URLs.
+  Applications can serve additional schemes by registering a
+  WPEQtUriSchemeHandler, at any time.
 */
 void WPEQtView::setUrl(const QUrl& url)
 {
@@ -403,7 +829,7 @@ void WPEQtView::setUrl(const QUrl& url)
 
     m_errorOccured = false;
     m_url = url;
-    if (m_webView)
+    if (m_webView && !WPEQtLoadScheduler::singleton()->isPending(this))
         webkit_web_view_load_uri(m_webView.get(), m_url.toString().toUtf8().constData());
 }
 
@@ -470,6 +896,7 @@ bool WPEQtView::canGoBack() const
   The \a loadRequest parameter holds the \e url and \e status of the request,
   as well as an \e errorString containing an error message for a failed
   request.
+  It also carries the timestamps of the load phases of the navigation.
 
   \sa WPEViewLoadRequest
 */
@@ -506,117 +933,637 @@ QColor WPEQtView::themeColor() const
     return qtColor;
 }
 
+static const quint32 sessionStateMagic = 0x57505153; // "WPQS"
+static const quint8 sessionStateVersion = 1;
+// Saved states outlive the Qt version that wrote them, pin the encoding.
+static const int sessionStateStreamVersion = QDataStream::Qt_5_12;
+
 /*!
-  \qmlmethod void WPEView::goBack()
+  \qmlmethod ArrayBuffer WPEView::saveState()
 
-  Navigates back in the web history.
+  Returns a compact binary snapshot of the navigation history of the view,
+  including the back/forward list and the current entry, suitable to be
+  persisted by the application and passed to \l restoreState() later.
+
+  \sa restoreState()
 */
-void WPEQtView::goBack()
+QByteArray WPEQtView::saveState() const
 {
-    if (m_webView)
-        webkit_web_view_go_back(m_webView.get());
+    if (!m_webView && !m_pendingSessionState.isEmpty())
+        return m_pendingSessionState;
+
+    QByteArray webkitState;
+    if (m_webView) {
+        auto* sessionState = webkit_web_view_get_session_state(m_webView.get());
+        GBytes* bytes = webkit_web_view_session_state_serialize(sessionState);
+        gsize size = 0;
+        const auto* data = static_cast<const char*>(g_bytes_get_data(bytes, &size));
+        webkitState = QByteArray(data, size);
+        g_bytes_unref(bytes);
+        webkit_web_view_session_state_unref(sessionState);
+    }
+
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(sessionStateStreamVersion);
+    stream << sessionStateMagic << sessionStateVersion << url() << webkitState;
+    return state;
 }
 
 /*!
-  \qmlmethod void WPEView::goForward()
+  \qmlmethod bool WPEView::restoreState(ArrayBuffer state)
 
-  Navigates forward in the web history.
+  Restores the navigation history saved with \l saveState(). Only the page
+  of the current history entry is loaded; the other entries are kept in the
+  back/forward list and loaded when navigated to.
+
+  If the web view has not been created yet, or its initial load is waiting
+  for WPELoadScheduler, the state is kept and restored then instead of
+  loading \l url.
+
+  Returns \c false if \a state is not a valid saved state.
 */
-void WPEQtView::goForward()
+bool WPEQtView::restoreState(const QByteArray& state)
 {
-    if (m_webView)
-        webkit_web_view_go_forward(m_webView.get());
+    quint32 magic = 0;
+    quint8 version = 0;
+    QUrl currentUrl;
+    QByteArray webkitState;
+    QDataStream stream(state);
+    stream.setVersion(sessionStateStreamVersion);
+    stream >> magic >> version;
+    if (magic != sessionStateMagic || version != sessionStateVersion)
+        return false;
+    stream >> currentUrl >> webkitState;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    m_url = currentUrl;
+    m_errorOccured = false;
+    if (!m_webView || WPEQtLoadScheduler::singleton()->isPending(this)) {
+        m_pendingSessionState = state;
+        return true;
+    }
+
+    WebKitWebViewSessionState* sessionState = nullptr;
+    if (!webkitState.isEmpty()) {
+        GBytes* bytes = g_bytes_new(webkitState.constData(), webkitState.size());
+        sessionState = webkit_web_view_session_state_new(bytes);
+        g_bytes_unref(bytes);
+    }
+
+    if (!sessionState) {
+        if (!m_url.isEmpty())
+            webkit_web_view_load_uri(m_webView.get(), m_url.toString().toUtf8().constData());
+        return !m_url.isEmpty();
+    }
+
+    webkit_web_view_restore_session_state(m_webView.get(), sessionState);
+    webkit_web_view_session_state_unref(sessionState);
+
+    auto* backForwardList = webkit_web_view_get_back_forward_list(m_webView.get());
+    if (auto* item = webkit_back_forward_list_get_current_item(backForwardList))
+        webkit_web_view_go_to_back_forward_list_item(m_webView.get(), item);
+    else if (!m_url.isEmpty())
+        webkit_web_view_load_uri(m_webView.get(), m_url.toString().toUtf8().constData());
+
+    return true;
 }
 
 /*!
-  \qmlmethod void WPEView::reload()
+  \qmlproperty int WPEView::resourceTraceSize
 
-  Reloads the current \l url.
+  The maximum number of resource loads recorded by the view. Each record
+  holds the URL, MIME type, HTTP status, size, start, response and end
+  times, and whether the resource was served from a cache. Once the limit
+  is reached the oldest records are dropped, and loads that did not finish
+  by then are no longer followed.
+
+  Tracing is disabled when the value is \c 0, which is the default.
+
+  \sa resourceLoads(), resourceLoadsHar()
 */
-void WPEQtView::reload()
+void WPEQtView::setResourceTraceSize(int size)
 {
-    if (m_webView)
-        webkit_web_view_reload(m_webView.get());
+    size = std::max(size, 0);
+    if (size == m_resourceTraceSize)
+        return;
+
+    m_resourceTraceSize = size;
+    if (!m_resourceTraceSize)
+        m_resourceTrace = nullptr;
+    else if (m_resourceTrace)
+        m_resourceTrace->setCapacity(m_resourceTraceSize);
+    else if (m_webView)
+        m_resourceTrace = std::make_unique<WPEQtResourceTrace>(m_webView.get(), m_resourceTraceSize);
+    Q_EMIT resourceTraceSizeChanged();
 }
 
 /*!
-  \qmlmethod void WPEView::stop()
+  \qmlmethod list<var> WPEView::resourceLoads()
 
-  Stops loading the current \l url.
+  Returns the recorded resource loads, oldest first. Each entry is an object
+  with the \c url, \c method, \c mimeType, \c status, \c size,
+  \c startTime, \c responseTime, \c endTime, \c cacheHit,
+  \c mainResource, \c finished and \c errorString properties.
+
+  Times are in milliseconds on the same monotonic clock as the
+  \l WPEViewLoadRequest timestamps, and are \c -1 when not reached yet. The
+  size is the content length announced by the server, or \c -1 if unknown.
+
+  WebKit does not report which resources were read from the disk cache:
+  \c cacheHit is only set for resources served from the memory cache and
+  for revalidated \c 304 responses.
+
+  \sa resourceTraceSize
 */
-void WPEQtView::stop()
+QVariantList WPEQtView::resourceLoads() const
 {
-    if (m_webView)
-        webkit_web_view_stop_loading(m_webView.get());
+    return m_resourceTrace ? m_resourceTrace->records() : QVariantList();
 }
 
-void WPEQtView::startLocationServices()
+/*!
+  \qmlmethod string WPEView::resourceLoadsHar()
+
+  Returns the recorded resource loads as an HTTP Archive (HAR 1.2) JSON
+  document, suitable to be attached to field reports and opened with the
+  usual waterfall viewers. Phases of loads that are still in progress have
+  a duration of 0, and their entries are marked with \c{_finished: false}.
+
+  \sa resourceLoads()
+*/
+QString WPEQtView::resourceLoadsHar() const
 {
-    QSharedPointer<QGeoPositionInfoSource> source = QSharedPointer<QGeoPositionInfoSource>(QGeoPositionInfoSource::createDefaultSource(this));
-    if (source.get()) {
-        connect(source.get(), &QGeoPositionInfoSource::positionUpdated,
-                this,[=](QGeoPositionInfo info){
-            // Update WebKit location
-            WebKitGeolocationPosition* position =
-                webkit_geolocation_position_new(info.coordinate().longitude(),
-                                                info.coordinate().latitude(),
-                                                15.0);
-            webkit_geolocation_manager_update_position(webkit_web_context_get_geolocation_manager(m_webContext.get()), position);
-            webkit_geolocation_position_free(position);
-        });
-        source->startUpdates();
-        m_locationSource = source;
-    }
+    return QString::fromUtf8(m_resourceTrace ? m_resourceTrace->toHar() : WPEQtResourceTrace::emptyHar());
 }
 
-void WPEQtView::stopLocationServices()
-{
-    if (!m_locationSource)
-        return;
+/*!
+  \qmlmethod void WPEView::clearResourceLoads()
 
-    m_locationSource->stopUpdates();
-    m_locationSource.reset(nullptr);
+  Discards the recorded resource loads.
+*/
+void WPEQtView::clearResourceLoads()
+{
+    if (m_resourceTrace)
+        m_resourceTrace->clear();
 }
 
 /*!
-  \qmlmethod void WPEView::loadHtml(string html, url baseUrl)
+  \qmlsignal WPEView::newViewRequested(WPENewViewRequest request)
 
-  Loads the specified \a html content to the web view.
+  This signal is emitted when the page requests a new view, for instance with
+  \c window.open() or a link targeting \c _blank.
 
-  This method offers a lower-level alternative to the \l url property,
-  which references HTML pages via URL.
+  To open the page in a new view, set \c request.view to a WPEView that did
+  not create its web view yet, from within the signal handler. The new view
+  shares the web process and the session of this view, and scripts of the new
+  page can reach their opener, as required by authentication popups. Using
+  the \c OnDemand \l createPolicy keeps the new view from creating its own
+  web view as soon as it is added to the window:
 
-  External objects such as stylesheets or images referenced in the HTML
-  document should be located relative to \a baseUrl. For example, if \a html
-  is retrieved from \c http://www.example.com/documents/overview.html, which
-  is the base URL, then an image referenced with the relative url, \c diagram.png,
-  should be at \c{http://www.example.com/documents/diagram.png}.
+  \badcode
+  Component {
+      id: popupComponent
+      WPEView { createPolicy: WPEView.OnDemand; anchors.fill: parent }
+  }
+
+  onNewViewRequested: function(request) {
+      request.view = popupComponent.createObject(window.contentItem)
+  }
+  \endcode
 
-  \note The WPEView does not support loading content through the Qt Resource system.
+  When no view is supplied, the requested page is loaded in this view.
 
-  \sa url
+  \sa closeRequested()
 */
-void WPEQtView::loadHtml(const QString& html, const QUrl& baseUrl)
-{
-    m_html = html;
-    m_baseUrl = baseUrl;
-    m_errorOccured = false;
 
-    if (m_webView)
-        webkit_web_view_load_html(m_webView.get(), html.toUtf8().constData(), baseUrl.toString().toUtf8().constData());
-}
+/*!
+  \qmlsignal WPEView::permissionRequested(WPEPermissionRequest request)
 
-struct JavascriptCallbackData {
-    JavascriptCallbackData(QJSValue cb, QPointer<WPEQtView> obj)
-        : callback(cb)
-        , object(obj) { }
+  This signal is emitted when a page requests a permission that has no
+  decision in the \l profile of the view. The \a request can be answered
+  right away or later on, for instance once the user was prompted:
 
-    QJSValue callback;
-    QPointer<WPEQtView> object;
-};
+  \badcode
+  onPermissionRequested: function(request) {
+      if (request.types & WPEProfile.GeolocationPermission)
+          request.allow()
+      else
+          request.deny(false)
+  }
+  \endcode
 
-static void jsAsyncReadyCallback(GObject* object, GAsyncResult* result, gpointer userData)
-{
+  Permissions are denied when the signal is not handled.
+
+  \sa {WPEProfile::setPermission()}{WPEProfile.setPermission()}
+*/
+
+/*!
+  \qmlsignal WPEView::closeRequested()
+
+  This signal is emitted when the page requests its view to be closed with
+  \c window.close(), which is usually the case of popups opened through
+  \l newViewRequested(). Destroying the view is up to the application.
+*/
+
+/*!
+  \qmlproperty WPEProcessInfo WPEView::processInfo
+  \readonly
+
+  The resource usage of the web process of the view: its identifier, memory
+  and CPU usage. The process is sampled periodically from the moment this
+  property is first read, and is known once the first load of the view
+  commits.
+
+  \sa WPEProcessMonitor
+*/
+WPEQtProcessInfo* WPEQtView::processInfo()
+{
+    if (!m_processInfo)
+        m_processInfo = new WPEQtProcessInfo(this);
+    return m_processInfo;
+}
+
+/*!
+  \qmlproperty bool WPEView::crashRecovery
+
+  When \c true, the view recovers automatically from web process
+  terminations caused by a crash or by the process exceeding its memory
+  limit: the frames exported by the dead process are released, and the last
+  committed page is reloaded, together with the navigation history, after a
+  delay. The delay starts at half a second and doubles with every attempt,
+  up to 30 seconds; it is reset once a recovered process stayed alive for a
+  minute.
+
+  The \l webProcessRecovering() signal is emitted when a reload is
+  scheduled, and \l webProcessRecoveryFailed() once \l maxRecoveryAttempts
+  consecutive attempts were made.
+
+  The default value is \c false.
+
+  \sa crashCount, memoryLimitTerminationCount
+*/
+void WPEQtView::setCrashRecovery(bool crashRecovery)
+{
+    if (crashRecovery == m_crashRecovery)
+        return;
+
+    m_crashRecovery = crashRecovery;
+    if (!m_crashRecovery) {
+        m_recoveryTimer.stop();
+        m_recoveryAttempts = 0;
+    }
+    Q_EMIT crashRecoveryChanged();
+}
+
+/*!
+  \qmlproperty int WPEView::maxRecoveryAttempts
+
+  The number of consecutive reloads attempted by \l crashRecovery before
+  giving up. The default value is \c 5.
+*/
+void WPEQtView::setMaxRecoveryAttempts(int maxRecoveryAttempts)
+{
+    maxRecoveryAttempts = std::max(maxRecoveryAttempts, 0);
+    if (maxRecoveryAttempts == m_maxRecoveryAttempts)
+        return;
+
+    m_maxRecoveryAttempts = maxRecoveryAttempts;
+    Q_EMIT maxRecoveryAttemptsChanged();
+}
+
+/*!
+  \qmlproperty int WPEView::crashCount
+  \readonly
+
+  The number of times the web process of the view crashed.
+
+  \sa memoryLimitTerminationCount
+*/
+
+/*!
+  \qmlproperty int WPEView::memoryLimitTerminationCount
+  \readonly
+
+  The number of times the web process of the view was terminated for
+  exceeding its memory limit.
+
+  \sa crashCount
+*/
+
+/*!
+  \qmlsignal WPEView::webProcessTerminated(enumeration reason)
+
+  This signal is emitted when the web process of the view terminated.
+
+  \value WPEView.CrashedTermination The web process crashed.
+  \value WPEView.MemoryLimitTermination The web process exceeded its memory limit.
+  \value WPEView.RequestedTermination The web process was terminated by the application.
+*/
+
+/*!
+  \qmlsignal WPEView::webProcessRecovering(int attempt, int delay)
+
+  This signal is emitted when \l crashRecovery schedules the reload of the
+  page after a web process termination, \a delay milliseconds from now.
+*/
+
+/*!
+  \qmlsignal WPEView::webProcessRecoveryFailed()
+
+  This signal is emitted when \l crashRecovery gives up after
+  \l maxRecoveryAttempts consecutive attempts.
+*/
+
+/*!
+  \qmlproperty enumeration WPEView::priority
+
+  The scheduling priority of the web process of the view, relative to the
+  other processes of the system.
+
+  \value WPEView.AutomaticPriority The priority follows the state of the
+         item: \c ForegroundPriority while it has the active focus,
+         \c NormalPriority while it is visible and \c BackgroundPriority
+         otherwise.
+  \value WPEView.ForegroundPriority The process runs with a nice value of -5.
+  \value WPEView.NormalPriority The process is left as started. This is the
+         default.
+  \value WPEView.BackgroundPriority The process runs with a nice value of 10.
+  \value WPEView.IdlePriority The process only runs when the CPUs would
+         otherwise be idle (\c SCHED_IDLE).
+
+  Views sharing a web process get the highest priority among them. Background
+  and idle processes can further be confined to
+  \l {WPEProcessMonitor::backgroundCpus}{WPEProcessMonitor.backgroundCpus}
+  and moved to a cgroup, see WPEProcessMonitor.
+
+  Lowering the nice value of a process, which is required for
+  \c ForegroundPriority and to raise the priority of a process again,
+  needs the \c CAP_SYS_NICE capability or a suitable \c RLIMIT_NICE; a
+  warning is printed once when it is missing.
+
+  The priority is only applied to the process that reported itself as the
+  web process of the view, see WPEProcessMonitor, so it takes effect once
+  the first load of the view commits. Processes are sampled periodically
+  while any view uses a priority other than \c NormalPriority.
+
+  The priority also orders the initial loads waiting in WPELoadScheduler.
+
+  \sa effectivePriority
+*/
+void WPEQtView::setPriority(Priority priority)
+{
+    if (priority == m_priority)
+        return;
+
+    m_priority = priority;
+    Q_EMIT priorityChanged();
+    updateEffectivePriority();
+}
+
+/*!
+  \qmlproperty enumeration WPEView::effectivePriority
+  \readonly
+
+  The priority applied to the web process of the view: the value of
+  \l priority, or with \c WPEView.AutomaticPriority the one derived from the
+  state of the item.
+*/
+void WPEQtView::updateEffectivePriority()
+{
+    Priority effectivePriority = m_priority;
+    if (effectivePriority == AutomaticPriority) {
+        if (hasActiveFocus())
+            effectivePriority = ForegroundPriority;
+        else if (isVisible())
+            effectivePriority = NormalPriority;
+        else
+            effectivePriority = BackgroundPriority;
+    }
+
+    if (effectivePriority == m_effectivePriority)
+        return;
+
+    m_effectivePriority = effectivePriority;
+    if (m_webView)
+        WPEQtProcessMonitor::singleton()->setViewPriority(this, m_effectivePriority);
+    Q_EMIT effectivePriorityChanged();
+}
+
+/*!
+  \qmlproperty bool WPEView::batchedSignals
+
+  When \c true, the \l url, \l title, \l loadProgress and \l themeColor
+  change notifications coming from WebKit are coalesced and delivered from
+  the Qt event loop instead of directly from the WebKit signal handlers.
+  This keeps heavy QML bindings from delaying WebKit IPC processing, at the
+  cost of the notifications arriving one event loop iteration later.
+
+  Pending notifications are always delivered before \l loadingChanged() is
+  emitted, so the relative ordering observed by QML is preserved.
+
+  The default value is \c false.
+*/
+void WPEQtView::setBatchedSignals(bool batchedSignals)
+{
+    if (batchedSignals == m_batchedSignals)
+        return;
+
+    m_batchedSignals = batchedSignals;
+    if (!m_batchedSignals)
+        flushPendingNotifications();
+    Q_EMIT batchedSignalsChanged();
+}
+
+/*!
+  \qmlproperty enumeration WPEView::createPolicy
+
+  This property controls when the underlying web view, and with it the web
+  process, is created.
+
+  \value WPEView.Immediate The web view is created as soon as the item is in a
+         window whose scene graph is initialized. This is the default.
+  \value WPEView.OnFirstVisible The web view is created the first time the item
+         is visible and has a non-empty size.
+  \value WPEView.OnDemand The web view is only created when \l create() is called.
+
+  The web view is never created before the item is completed by QML, so the
+  policy and \l profile bindings always apply. Until the web view exists,
+  the \l url and content passed to \l loadHtml() are kept and applied on
+  creation, and scripts passed to \l runJavaScript() are queued. Changing the policy has no effect once the
+  web view has been created.
+
+  \sa create(), webViewCreated()
+*/
+void WPEQtView::setCreatePolicy(CreatePolicy createPolicy)
+{
+    if (createPolicy == m_createPolicy)
+        return;
+
+    m_createPolicy = createPolicy;
+    Q_EMIT createPolicyChanged();
+    maybeCreateWebView();
+}
+
+/*!
+  \qmlproperty WPEProfile WPEView::profile
+
+  The profile holding the state this view shares with other views: the
+  network session, web context and user content such as content filters.
+  When not set, the application-wide default profile is used.
+
+  The profile must be set before the web view is created; later changes are ignored.
+
+  \sa createPolicy
+*/
+WPEQtProfile* WPEQtView::profile() const
+{
+    return m_profile ? m_profile.data() : WPEQtProfile::defaultProfile();
+}
+
+void WPEQtView::setProfile(WPEQtProfile* profile)
+{
+    if (profile == m_profile)
+        return;
+
+    if (m_webView) {
+        qWarning("WPEView: the profile cannot be changed after the web view has been created");
+        return;
+    }
+
+    m_profile = profile;
+    Q_EMIT profileChanged();
+}
+
+/*!
+  \qmlmethod void WPEView::create()
+
+  Requests the web view to be created regardless of \l createPolicy. If the
+  item is not yet in a window with an initialized scene graph, creation
+  happens as soon as it is.
+*/
+void WPEQtView::create()
+{
+    m_createRequested = true;
+    maybeCreateWebView();
+}
+
+/*!
+  \qmlmethod void WPEView::goBack()
+
+  Navigates back in the web history.
+*/
+void WPEQtView::goBack()
+{
+    if (m_webView)
+        webkit_web_view_go_back(m_webView.get());
+}
+
+/*!
+  \qmlmethod void WPEView::goForward()
+
+  Navigates forward in the web history.
+*/
+void WPEQtView::goForward()
+{
+    if (m_webView)
+        webkit_web_view_go_forward(m_webView.get());
+}
+
+/*!
+  \qmlmethod void WPEView::reload()
+
+  Reloads the current \l url.
+*/
+void WPEQtView::reload()
+{
+    if (m_webView)
+        webkit_web_view_reload(m_webView.get());
+}
+
+/*!
+  \qmlmethod void WPEView::stop()
+
+  Stops loading the current \l url.
+*/
+void WPEQtView::stop()
+{
+    if (m_webView)
+        webkit_web_view_stop_loading(m_webView.get());
+}
+
+/*!
+  \qmlmethod void WPEView::startLocationServices()
+
+  Keeps the position source shared by all the views running, for instance to
+  get a position fix before pages request it. Pages start and stop the source
+  on their own through the Geolocation API. Nothing is kept running when no
+  position source is available; calling it again retries.
+
+  \sa stopLocationServices(), WPEGeolocation
+*/
+void WPEQtView::startLocationServices()
+{
+    if (m_locationServicesStarted)
+        return;
+
+    m_locationServicesStarted = WPEQtGeolocation::singleton()->acquire();
+}
+
+/*!
+  \qmlmethod void WPEView::stopLocationServices()
+
+  Releases the position source kept running by \l startLocationServices().
+*/
+void WPEQtView::stopLocationServices()
+{
+    if (!m_locationServicesStarted)
+        return;
+
+    m_locationServicesStarted = false;
+    WPEQtGeolocation::singleton()->release();
+}
+
+/*!
+  \qmlmethod void WPEView::loadHtml(string html, url baseUrl)
+
+  Loads the specified \a html content to the web view.
+
+  This method offers a lower-level alternative to the \l url property,
+  which references HTML pages via URL.
+
+  External objects such as stylesheets or images referenced in the HTML
+  document should be located relative to \a baseUrl. For example, if \a html
+  is retrieved from \c http://www.example.com/documents/overview.html, which
+  is the base URL, then an image referenced with the relative url, \c diagram.png,
+  should be at \c{http://www.example.com/documents/diagram.png}.
+
+  \note Prefer setting \l url to a \c qrc: URL for documents bundled with
+  the application, which streams them instead of copying the whole document.
+
+  \sa url
+*/
+void WPEQtView::loadHtml(const QString& html, const QUrl& baseUrl)
+{
+    m_html = html;
+    m_baseUrl = baseUrl;
+    m_errorOccured = false;
+
+    if (m_webView && !WPEQtLoadScheduler::singleton()->isPending(this))
+        webkit_web_view_load_html(m_webView.get(), html.toUtf8().constData(), baseUrl.toString().toUtf8().constData());
+}
+
+struct JavascriptCallbackData {
+    JavascriptCallbackData(QJSValue cb, QPointer<WPEQtView> obj)
+        : callback(cb)
+        , object(obj) { }
+
+    QJSValue callback;
+    QPointer<WPEQtView> object;
+};
+
+static void jsAsyncReadyCallback(GObject* object, GAsyncResult* result, gpointer userData)
+{
     GUniqueOutPtr<GError> error;
     std::unique_ptr<JavascriptCallbackData> data(reinterpret_cast<JavascriptCallbackData*>(userData));
 
@@ -674,9 +1621,19 @@ static void jsAsyncReadyCallback(GObject* object, GAsyncResult* result, gpointer
   \badcode
   runJavaScript("document.title", function(result) { console.log(result); });
   \endcode
+
+  Scripts run before the web view is created are queued, and run in order
+  once it is, in the document shown at that time.
+
+  \sa createPolicy
 */
 void WPEQtView::runJavaScript(const QString& script, const QJSValue& callback)
 {
+    if (!m_webView) {
+        m_pendingJavaScript.append(qMakePair(script, callback));
+        return;
+    }
+
     std::unique_ptr<JavascriptCallbackData> data = std::make_unique<JavascriptCallbackData>(callback, QPointer<WPEQtView>(this));
 #if WEBKIT_CHECK_VERSION(2, 40, 0)
     webkit_web_view_evaluate_javascript(m_webView.get(), script.toUtf8().constData(), -1, nullptr, nullptr, nullptr, jsAsyncReadyCallback, data.release());
@@ -685,6 +1642,354 @@ void WPEQtView::runJavaScript(const QString& script, const QJSValue& callback)
 #endif
 }
 
+/*!
+  \qmlmethod void WPEView::prefetch(url url)
+
+  Prepares a navigation to \a url that is likely to follow, such as the
+  entries of a menu, by resolving its host ahead of time through
+  \l {WPEProfile::prefetchDns()}{WPEProfile.prefetchDns()}. The current page
+  is left untouched.
+
+  \sa prefetchOnHover
+*/
+void WPEQtView::prefetch(const QUrl& url)
+{
+    if (url.host().isEmpty())
+        return;
+
+    // WebKit has no API to open connections ahead of time, and hinting one
+    // through the page would be visible to its scripts.
+    profile()->prefetchDns(url.host());
+}
+
+/*!
+  \qmlproperty bool WPEView::prefetchOnHover
+
+  When \c true, the links of the page are passed to \l prefetch() when they
+  are hovered with the mouse for a tenth of a second, or touched and held for
+  the press and hold interval of the platform. The default value is
+  \c false.
+*/
+void WPEQtView::setPrefetchOnHover(bool prefetchOnHover)
+{
+    if (prefetchOnHover == m_prefetchOnHover)
+        return;
+
+    m_prefetchOnHover = prefetchOnHover;
+    if (!m_prefetchOnHover) {
+        m_prefetchTimer.stop();
+        m_longPressTimer.stop();
+    }
+    Q_EMIT prefetchOnHoverChanged();
+}
+
+void WPEQtView::mouseTargetChangedCallback(WebKitWebView*, WebKitHitTestResult* hitTestResult, guint, WPEQtView* view)
+{
+    if (!view->m_prefetchOnHover)
+        return;
+
+    if (!webkit_hit_test_result_context_is_link(hitTestResult)) {
+        view->m_prefetchTimer.stop();
+        return;
+    }
+
+    const QUrl url(QString::fromUtf8(webkit_hit_test_result_get_link_uri(hitTestResult)));
+    if (url == view->m_prefetchCandidate && view->m_prefetchTimer.isActive())
+        return;
+
+    view->m_prefetchCandidate = url;
+    view->m_prefetchTimer.start();
+}
+
+void WPEQtView::updateLongPress(QTouchEvent* event)
+{
+    const auto& points = event->touchPoints();
+    switch (event->type()) {
+    case QEvent::TouchBegin:
+        if (points.size() == 1) {
+            m_longPressPosition = points.first().pos();
+            m_longPressTimer.start(QGuiApplication::styleHints()->mousePressAndHoldInterval());
+        }
+        break;
+    case QEvent::TouchUpdate:
+        if (points.size() != 1 || (points.first().pos() - m_longPressPosition).manhattanLength() > QGuiApplication::styleHints()->startDragDistance())
+            m_longPressTimer.stop();
+        break;
+    default:
+        m_longPressTimer.stop();
+        break;
+    }
+}
+
+// WebKit only reports the element under the mouse, so the link under a
+// touch point is looked up in the page.
+void WPEQtView::prefetchLinkAt(const QPointF& position)
+{
+    if (!m_webView)
+        return;
+
+    const qreal zoomLevel = webkit_web_view_get_zoom_level(m_webView.get());
+    const QString script = QStringLiteral("(function() { var element = document.elementFromPoint(%1, %2);"
+        " var link = element && element.closest('a[href]'); return link ? link.href : ''; })();")
+        .arg(position.x() / zoomLevel).arg(position.y() / zoomLevel);
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    webkit_web_view_evaluate_javascript(m_webView.get(), script.toUtf8().constData(), -1, "wpeqt-prefetch", nullptr, nullptr, linkAtPointCallback, new QPointer<WPEQtView>(this));
+#else
+    webkit_web_view_run_javascript_in_world(m_webView.get(), script.toUtf8().constData(), "wpeqt-prefetch", nullptr, linkAtPointCallback, new QPointer<WPEQtView>(this));
+#endif
+}
+
+void WPEQtView::linkAtPointCallback(GObject* object, GAsyncResult* result, gpointer userData)
+{
+    std::unique_ptr<QPointer<WPEQtView>> view(static_cast<QPointer<WPEQtView>*>(userData));
+
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+    GRefPtr<JSCValue> value = adoptGRef(webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(object), result, nullptr));
+#else
+    WebKitJavascriptResult* jsResult = webkit_web_view_run_javascript_in_world_finish(WEBKIT_WEB_VIEW(object), result, nullptr);
+    GRefPtr<JSCValue> value = jsResult ? webkit_javascript_result_get_js_value(jsResult) : nullptr;
+    if (jsResult)
+        webkit_javascript_result_unref(jsResult);
+#endif
+    if (!value || !jsc_value_is_string(value.get()) || !*view)
+        return;
+
+    GUniquePtr<gchar> link(jsc_value_to_string(value.get()));
+    if (*link.get())
+        (*view)->prefetch(QUrl(QString::fromUtf8(link.get())));
+}
+
+/*!
+  \qmlmethod void WPEView::findText(string text, int options)
+
+  Highlights the matches of \a text in the page and selects the first one
+  after the current selection. \a options is a combination of
+  \c WPEView.FindBackward, \c WPEView.FindCaseSensitively,
+  \c WPEView.FindAtWordStarts and \c WPEView.FindNoWrapAround; by default
+  the search ignores case and wraps around the page.
+
+  The method is meant to be called as the user types: the search starts once
+  \a text has not changed for \l findDelay, and continues from the current
+  match, so extending \a text keeps the selection in place when it still
+  matches. The matchCount() signal is emitted with the result. An empty
+  \a text ends the search and removes the highlights.
+
+  \sa findNext(), findPrevious(), maxFindMatches
+*/
+void WPEQtView::findText(const QString& text, int options)
+{
+    m_findText = text;
+    m_findOptions = options;
+
+    if (text.isEmpty()) {
+        m_findTimer.stop();
+        if (m_webView && !m_searchedText.isEmpty())
+            webkit_find_controller_search_finish(webkit_web_view_get_find_controller(m_webView.get()));
+        m_searchedText.clear();
+        return;
+    }
+
+    if (text == m_searchedText && options == m_searchedOptions) {
+        m_findTimer.stop();
+        return;
+    }
+    m_findTimer.start();
+}
+
+/*!
+  \qmlmethod void WPEView::findNext()
+
+  Selects the next match of the text passed to findText(), starting the
+  search right away if it is still delayed.
+
+  \sa findPrevious()
+*/
+void WPEQtView::findNext()
+{
+    if (m_findTimer.isActive() || m_searchedText != m_findText) {
+        search();
+        return;
+    }
+    if (m_webView && !m_searchedText.isEmpty())
+        webkit_find_controller_search_next(webkit_web_view_get_find_controller(m_webView.get()));
+}
+
+/*!
+  \qmlmethod void WPEView::findPrevious()
+
+  Selects the previous match of the text passed to findText(), starting the
+  search right away if it is still delayed.
+
+  \sa findNext()
+*/
+void WPEQtView::findPrevious()
+{
+    if (m_findTimer.isActive() || m_searchedText != m_findText) {
+        search();
+        return;
+    }
+    if (m_webView && !m_searchedText.isEmpty())
+        webkit_find_controller_search_previous(webkit_web_view_get_find_controller(m_webView.get()));
+}
+
+/*!
+  \qmlproperty int WPEView::maxFindMatches
+
+  The number of matches past which findText() stops counting, which bounds
+  the work done for short texts in large documents. matchCount() reports
+  \c -1 when the page has more matches. The default value is \c 1000.
+*/
+void WPEQtView::setMaxFindMatches(int maxFindMatches)
+{
+    maxFindMatches = std::max(maxFindMatches, 1);
+    if (maxFindMatches == m_maxFindMatches)
+        return;
+
+    m_maxFindMatches = maxFindMatches;
+    if (!m_searchedText.isEmpty()) {
+        m_searchedText.clear();
+        m_findTimer.start();
+    }
+    Q_EMIT maxFindMatchesChanged();
+}
+
+/*!
+  \qmlproperty int WPEView::findDelay
+
+  The time in milliseconds findText() waits for the text to stop changing
+  before searching. The default value is \c 150.
+*/
+void WPEQtView::setFindDelay(int findDelay)
+{
+    findDelay = std::max(findDelay, 0);
+    if (findDelay == m_findTimer.interval())
+        return;
+
+    m_findTimer.setInterval(findDelay);
+    Q_EMIT findDelayChanged();
+}
+
+void WPEQtView::search()
+{
+    m_findTimer.stop();
+    if (!m_webView || m_findText.isEmpty())
+        return;
+
+    m_searchedText = m_findText;
+    m_searchedOptions = m_findOptions;
+
+    guint32 options = 0;
+    if (m_findOptions & FindBackward)
+        options |= WEBKIT_FIND_OPTIONS_BACKWARDS;
+    if (!(m_findOptions & FindCaseSensitively))
+        options |= WEBKIT_FIND_OPTIONS_CASE_INSENSITIVE;
+    if (m_findOptions & FindAtWordStarts)
+        options |= WEBKIT_FIND_OPTIONS_AT_WORD_STARTS;
+    if (!(m_findOptions & FindNoWrapAround))
+        options |= WEBKIT_FIND_OPTIONS_WRAP_AROUND;
+    webkit_find_controller_search(webkit_web_view_get_find_controller(m_webView.get()), m_searchedText.toUtf8().constData(), options, m_maxFindMatches);
+}
+
+/*!
+  \qmlsignal WPEView::matchCount(int count)
+
+  Emitted when a search started by findText(), findNext() or findPrevious()
+  completes, with the number of matches of the text in the page: \c 0 when
+  the text was not found, and \c -1 when there are more than
+  \l maxFindMatches.
+*/
+void WPEQtView::foundTextCallback(WebKitFindController*, guint matchCount, WPEQtView* view)
+{
+    Q_EMIT view->matchCount(matchCount == G_MAXUINT ? -1 : static_cast<int>(matchCount));
+}
+
+void WPEQtView::failedToFindTextCallback(WebKitFindController*, WPEQtView* view)
+{
+    Q_EMIT view->matchCount(0);
+}
+
+/*!
+  Asynchronously reads back the current content of the view and invokes
+  \a callback with it on the view's thread. When \a size is valid the
+  image is downscaled on the GPU to fit within it, keeping the aspect ratio.
+
+  The read back is performed with pixel buffer objects and fences when the
+  OpenGL context supports them, so the render thread is never stalled
+  waiting for the GPU. The callback is never invoked synchronously; it
+  receives a null image if the view has no content or is hidden, including
+  when that happens before the read back completes.
+*/
+void WPEQtView::grabSnapshot(const QSize& size, std::function<void(const QImage&)>&& callback)
+{
+    // Snapshots are taken while rendering, which hidden views never do.
+    if (!m_backend || !isVisible() || !window() || !window()->isExposed()) {
+        QMetaObject::invokeMethod(this, [callback = std::move(callback)] {
+            if (callback)
+                callback(QImage());
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    m_backend->requestSnapshot(size, std::move(callback));
+}
+
+static void invokeSnapshotCallback(QPointer<WPEQtView> view, QJSValue callback, const QImage& image)
+{
+    if (!view || !callback.isCallable())
+        return;
+
+    QQmlEngine* engine = qmlEngine(view.data());
+    if (!engine) {
+        qWarning("No JavaScript engine, unable to handle snapshot callback!");
+        return;
+    }
+
+    QJSValueList args;
+    args.append(engine->toScriptValue(QVariant(image)));
+    callback.call(args);
+}
+
+/*!
+  \qmlmethod void WPEView::snapshot(variant callback)
+
+  Captures the current content of the view at full resolution. The
+  \a callback is invoked later with the resulting image, which is null
+  if the view is hidden or has not rendered anything yet.
+
+  Unlike \c grabToImage(), the read back happens asynchronously and does
+  not re-render the scene.
+
+  \sa thumbnail()
+*/
+void WPEQtView::snapshot(const QJSValue& callback)
+{
+    QPointer<WPEQtView> view(this);
+    grabSnapshot(QSize(), [view, callback](const QImage& image) {
+        invokeSnapshotCallback(view, callback, image);
+    });
+}
+
+/*!
+  \qmlmethod void WPEView::thumbnail(size size, variant callback)
+
+  Captures the current content of the view downscaled on the GPU to fit
+  within \a size, keeping the aspect ratio. The \a callback is invoked
+  later with the resulting image.
+
+  \badcode
+  thumbnail(Qt.size(320, 180), function(image) { tabModel.setThumbnail(index, image); });
+  \endcode
+
+  \sa snapshot()
+*/
+void WPEQtView::thumbnail(const QSize& size, const QJSValue& callback)
+{
+    QPointer<WPEQtView> view(this);
+    grabSnapshot(size, [view, callback](const QImage& image) {
+        invokeSnapshotCallback(view, callback, image);
+    });
+}
+
 void WPEQtView::mouseMoveEvent(QMouseEvent* event)
 {
     if (m_backend)
@@ -743,6 +2048,8 @@ void WPEQtView::keyReleaseEvent(QKeyEvent* event)
 void WPEQtView::touchEvent(QTouchEvent* event)
 {
     forceActiveFocus();
+    if (m_prefetchOnHover)
+        updateLongPress(event);
     if (m_backend)
         m_backend->dispatchTouchEvent(event);
 }
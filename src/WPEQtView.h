@@ -21,16 +21,28 @@
 #pragma once
 
 #include "config.h"
+#include "WPEQtProfile.h"
 
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPointer>
 #include <QQmlEngine>
 #include <QQuickItem>
 #include <QSharedPointer>
+#include <QTimer>
 #include <QUrl>
-#include <QGeoPositionInfoSource>
+#include <QVector>
+#include <array>
+#include <functional>
 #include <memory>
 #include <wpe/webkit.h>
 #include <wtf/glib/GRefPtr.h>
 
+class WPEQtFrameStream;
+class WPEQtNewViewRequest;
+class WPEQtPermissionRequest;
+class WPEQtProcessInfo;
+class WPEQtResourceTrace;
 class WPEQtViewBackend;
 class WPEQtViewLoadRequest;
 
@@ -44,7 +56,25 @@ class WPEQtView : public QQuickItem {
     Q_PROPERTY(bool canGoBack READ canGoBack NOTIFY loadingChanged)
     Q_PROPERTY(bool canGoForward READ canGoForward NOTIFY loadingChanged)
     Q_PROPERTY(QColor themeColor READ themeColor NOTIFY themeColorChanged)
+    Q_PROPERTY(bool batchedSignals READ batchedSignals WRITE setBatchedSignals NOTIFY batchedSignalsChanged)
+    Q_PROPERTY(CreatePolicy createPolicy READ createPolicy WRITE setCreatePolicy NOTIFY createPolicyChanged)
+    Q_PROPERTY(WPEQtProfile* profile READ profile WRITE setProfile NOTIFY profileChanged)
+    Q_PROPERTY(int resourceTraceSize READ resourceTraceSize WRITE setResourceTraceSize NOTIFY resourceTraceSizeChanged)
+    Q_PROPERTY(WPEQtProcessInfo* processInfo READ processInfo CONSTANT)
+    Q_PROPERTY(bool crashRecovery READ crashRecovery WRITE setCrashRecovery NOTIFY crashRecoveryChanged)
+    Q_PROPERTY(int maxRecoveryAttempts READ maxRecoveryAttempts WRITE setMaxRecoveryAttempts NOTIFY maxRecoveryAttemptsChanged)
+    Q_PROPERTY(int crashCount READ crashCount NOTIFY crashCountChanged)
+    Q_PROPERTY(int memoryLimitTerminationCount READ memoryLimitTerminationCount NOTIFY crashCountChanged)
+    Q_PROPERTY(Priority priority READ priority WRITE setPriority NOTIFY priorityChanged)
+    Q_PROPERTY(Priority effectivePriority READ effectivePriority NOTIFY effectivePriorityChanged)
+    Q_PROPERTY(bool prefetchOnHover READ prefetchOnHover WRITE setPrefetchOnHover NOTIFY prefetchOnHoverChanged)
+    Q_PROPERTY(int maxFindMatches READ maxFindMatches WRITE setMaxFindMatches NOTIFY maxFindMatchesChanged)
+    Q_PROPERTY(int findDelay READ findDelay WRITE setFindDelay NOTIFY findDelayChanged)
     Q_ENUMS(LoadStatus)
+    Q_ENUMS(CreatePolicy)
+    Q_ENUMS(TerminationReason)
+    Q_ENUMS(Priority)
+    Q_ENUMS(FindOption)
 
 public:
     enum LoadStatus {
@@ -54,6 +84,33 @@ public:
         LoadFailedStatus
     };
 
+    enum CreatePolicy {
+        Immediate,
+        OnFirstVisible,
+        OnDemand
+    };
+
+    enum TerminationReason {
+        CrashedTermination,
+        MemoryLimitTermination,
+        RequestedTermination
+    };
+
+    enum Priority {
+        AutomaticPriority,
+        ForegroundPriority,
+        NormalPriority,
+        BackgroundPriority,
+        IdlePriority
+    };
+
+    enum FindOption {
+        FindBackward = 1 << 0,
+        FindCaseSensitively = 1 << 1,
+        FindAtWordStarts = 1 << 2,
+        FindNoWrapAround = 1 << 3
+    };
+
     WPEQtView(QQuickItem* parent = nullptr);
     ~WPEQtView();
     QSGNode* updatePaintNode(QSGNode*, UpdatePaintNodeData*) final;
@@ -68,16 +125,54 @@ public:
     bool isLoading() const;
     bool canGoForward() const;
     QColor themeColor() const;
+    bool batchedSignals() const { return m_batchedSignals; };
+    void setBatchedSignals(bool);
+    CreatePolicy createPolicy() const { return m_createPolicy; };
+    void setCreatePolicy(CreatePolicy);
+    WPEQtProfile* profile() const;
+    void setProfile(WPEQtProfile*);
+    int resourceTraceSize() const { return m_resourceTraceSize; };
+    void setResourceTraceSize(int);
+    WPEQtProcessInfo* processInfo();
+    bool crashRecovery() const { return m_crashRecovery; };
+    void setCrashRecovery(bool);
+    int maxRecoveryAttempts() const { return m_maxRecoveryAttempts; };
+    void setMaxRecoveryAttempts(int);
+    int crashCount() const { return m_crashCount; };
+    int memoryLimitTerminationCount() const { return m_memoryLimitTerminationCount; };
+    Priority priority() const { return m_priority; };
+    void setPriority(Priority);
+    Priority effectivePriority() const { return m_effectivePriority; };
+    bool prefetchOnHover() const { return m_prefetchOnHover; };
+    void setPrefetchOnHover(bool);
+    int maxFindMatches() const { return m_maxFindMatches; };
+    void setMaxFindMatches(int);
+    int findDelay() const { return m_findTimer.interval(); };
+    void setFindDelay(int);
 
     void makeFileChooserRequest(WebKitFileChooserRequest* request);
 
+    Q_INVOKABLE QByteArray saveState() const;
+    Q_INVOKABLE bool restoreState(const QByteArray&);
+    Q_INVOKABLE QVariantList resourceLoads() const;
+    Q_INVOKABLE QString resourceLoadsHar() const;
+    Q_INVOKABLE void clearResourceLoads();
+    void grabSnapshot(const QSize&, std::function<void(const QImage&)>&&);
+
 public Q_SLOTS:
+    void create();
     void goBack();
     void goForward();
     void reload();
     void stop();
     void loadHtml(const QString& html, const QUrl& baseUrl = QUrl());
     void runJavaScript(const QString& script, const QJSValue& callback = QJSValue());
+    void prefetch(const QUrl& url);
+    void findText(const QString& text, int options = 0);
+    void findNext();
+    void findPrevious();
+    void snapshot(const QJSValue& callback);
+    void thumbnail(const QSize& size, const QJSValue& callback);
     void confirmFileSelection(const QStringList files);
     void cancelFileSelection();
     void startLocationServices();
@@ -85,12 +180,31 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     void webViewCreated();
+    void newViewRequested(WPEQtNewViewRequest* request);
+    void permissionRequested(WPEQtPermissionRequest* request);
+    void closeRequested();
     void urlChanged();
     void titleChanged();
     void loadingChanged(WPEQtViewLoadRequest* loadRequest);
     void loadProgressChanged();
     void themeColorChanged();
+    void batchedSignalsChanged();
+    void createPolicyChanged();
+    void profileChanged();
+    void resourceTraceSizeChanged();
     void webProcessCrashed();
+    void webProcessTerminated(TerminationReason reason);
+    void webProcessRecovering(int attempt, int delay);
+    void webProcessRecoveryFailed();
+    void crashRecoveryChanged();
+    void maxRecoveryAttemptsChanged();
+    void crashCountChanged();
+    void priorityChanged();
+    void effectivePriorityChanged();
+    void prefetchOnHoverChanged();
+    void maxFindMatchesChanged();
+    void findDelayChanged();
+    void matchCount(int count);
     void fileSelectionRequested(const bool multiple, const QStringList mimeTypes);
 
 protected:
@@ -102,6 +216,7 @@ protected:
 #else
     void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
 #endif
+    void componentComplete() override;
 
     void hoverEnterEvent(QHoverEvent*) override;
     void hoverLeaveEvent(QHoverEvent*) override;
@@ -122,9 +237,36 @@ protected:
 
 private Q_SLOTS:
     void configureWindow();
+    void maybeCreateWebView();
     void createWebView();
+    void flushPendingNotifications();
+    void recoverWebProcess();
+    void updateEffectivePriority();
 
 private:
+    enum PendingNotification {
+        UrlNotification = 1 << 0,
+        TitleNotification = 1 << 1,
+        LoadProgressNotification = 1 << 2,
+        ThemeColorNotification = 1 << 3
+    };
+    void queueNotification(PendingNotification);
+
+    void createWebView(WebKitWebView* relatedView);
+    WebKitWebView* createRelatedWebView(WPEQtView* opener);
+    bool loadInitialContent();
+    Priority loadPriority() const;
+
+    WPEQtViewLoadRequest* beginLoadRequest(const QUrl&);
+    WPEQtViewLoadRequest* currentLoadRequest();
+    void updateLoadRequest(WPEQtViewLoadRequest*);
+    void didDisplayFrame();
+    void collectNavigationTiming();
+    void requestWebProcessIdentifier();
+    void updateLongPress(QTouchEvent*);
+    void prefetchLinkAt(const QPointF&);
+    void search();
+
     static void notifyUrlChangedCallback(WPEQtView*);
     static void notifyTitleChangedCallback(WPEQtView*);
     static void notifyLoadProgressCallback(WPEQtView*);
@@ -133,24 +275,69 @@ private:
     static void notifyThemeColorChangedCallback(WPEQtView*);
     static void notifyWebProcessTerminatedCallback(WebKitWebView*, WebKitWebProcessTerminationReason, WPEQtView*);
     static void notifyRunFileChooserCallback(WebKitWebView*, WebKitFileChooserRequest* request, WPEQtView*);
-    static void notifyPermissionRequestCallback(WebKitWebView *web_view, WebKitPermissionRequest *permission_request, WPEQtView* view);
-    static void notifyLocationManagerStart(WebKitWebView*, WebKitGeolocationManager* manager, WPEQtView*);
-    static void notifyLocationManagerStop(WebKitWebView*, WebKitGeolocationManager* manager, WPEQtView*);
-    static void *createRequested(WebKitWebView*, WebKitNavigationAction*, WPEQtView*);
+    static gboolean notifyPermissionRequestCallback(WebKitWebView*, WebKitPermissionRequest*, WPEQtView*);
+    static void navigationTimingReadyCallback(GObject*, GAsyncResult*, gpointer);
+    static void webProcessIdentifierCallback(GObject*, GAsyncResult*, gpointer);
+    static WebKitWebView* createRequested(WebKitWebView*, WebKitNavigationAction*, WPEQtView*);
+    static void notifyCloseCallback(WebKitWebView*, WPEQtView*);
+    static void mouseTargetChangedCallback(WebKitWebView*, WebKitHitTestResult*, guint modifiers, WPEQtView*);
+    static void linkAtPointCallback(GObject*, GAsyncResult*, gpointer);
+    static void foundTextCallback(WebKitFindController*, guint matchCount, WPEQtView*);
+    static void failedToFindTextCallback(WebKitFindController*, WPEQtView*);
 
     GRefPtr<WebKitWebView> m_webView;
     GRefPtr<WebKitNetworkSession> m_networkSession;
     GRefPtr<WebKitWebContext> m_webContext;
     WebKitFileChooserRequest* m_currentFileChooserRequest { nullptr };
     QUrl m_url;
+    QUrl m_committedUrl;
     QString m_html;
     QUrl m_baseUrl;
+    QByteArray m_pendingSessionState;
     QSizeF m_size;
     WPEQtViewBackend* m_backend { nullptr };
+    QPointer<WPEQtProfile> m_profile;
     bool m_errorOccured { false };
+    bool m_batchedSignals { false };
+    CreatePolicy m_createPolicy { Immediate };
+    bool m_createRequested { false };
+    QVector<QPair<QString, QJSValue>> m_pendingJavaScript;
+    bool m_notificationFlushScheduled { false };
+    unsigned m_pendingNotifications { 0 };
     WebKitInputMethodContext *m_imContext = nullptr;
-    WebKitGeolocationManager *m_locationManager = nullptr;
-    QSharedPointer<QGeoPositionInfoSource> m_locationSource;
+    bool m_locationServicesStarted { false };
+    QList<QPointer<WPEQtFrameStream>> m_frameStreams;
+    std::array<std::unique_ptr<WPEQtViewLoadRequest>, 2> m_loadRequests;
+    unsigned m_currentLoadRequest { 0 };
+    quint64 m_navigationId { 0 };
+    bool m_awaitingFirstFrame { false };
+    int m_resourceTraceSize { 0 };
+    bool m_crashRecovery { false };
+    int m_maxRecoveryAttempts { 5 };
+    int m_recoveryAttempts { 0 };
+    int m_crashCount { 0 };
+    int m_memoryLimitTerminationCount { 0 };
+    Priority m_priority { NormalPriority };
+    Priority m_effectivePriority { NormalPriority };
+    bool m_prefetchOnHover { false };
+    QUrl m_prefetchCandidate;
+    QTimer m_prefetchTimer;
+    QTimer m_longPressTimer;
+    QPointF m_longPressPosition;
+    QString m_findText;
+    int m_findOptions { 0 };
+    QString m_searchedText;
+    int m_searchedOptions { 0 };
+    int m_maxFindMatches { 1000 };
+    QTimer m_findTimer;
+    QElapsedTimer m_sinceLastRecovery;
+    QTimer m_recoveryTimer;
+    QByteArray m_recoveryState;
+    std::unique_ptr<WPEQtResourceTrace> m_resourceTrace;
+    WPEQtProcessInfo* m_processInfo { nullptr };
 
+    friend class WPEQtFrameStream;
+    friend class WPEQtLoadScheduler;
+    friend class WPEQtProcessMonitor;
     friend class WPEQtViewBackend;
 };
@@ -21,99 +21,132 @@
 #include "config.h"
 #include "WPEQtViewBackend.h"
 
+#include "WPEQtBackendFactory.h"
+#include "WPEQtFrameStream.h"
 #include "WPEQtView.h"
 #include <QGuiApplication>
+#include <QMutex>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLFunctions>
+#include <QRunnable>
+#include <QThread>
 #include <QtGlobal>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-static PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture2DOES;
-
-std::unique_ptr<WPEQtViewBackend> WPEQtViewBackend::create(const QSizeF& size, QPointer<QOpenGLContext> context, EGLDisplay eglDisplay, QPointer<WPEQtView> view)
-{
-    if (!context || !view)
-        return nullptr;
+// Exported images handed out to frame streams stay locked until the last frame
+// referencing them is dropped, even if the backend is done displaying them.
+struct WPEQtViewBackend::ImageLeases : std::enable_shared_from_this<WPEQtViewBackend::ImageLeases> {
+    void release(struct wpe_fdo_egl_exported_image* image)
+    {
+        QMutexLocker locker(&mutex);
+        auto it = holds.find(image);
+        if (it != holds.end()) {
+            deferred.insert(image);
+            return;
+        }
+        if (exportable)
+            wpe_view_backend_exportable_fdo_egl_dispatch_release_exported_image(exportable, image);
+    }
 
-    if (eglDisplay == EGL_NO_DISPLAY)
-        return nullptr;
+    void hold(struct wpe_fdo_egl_exported_image* image)
+    {
+        QMutexLocker locker(&mutex);
+        ++holds[image];
+    }
 
-    eglInitialize(eglDisplay, nullptr, nullptr);
+    void drop(struct wpe_fdo_egl_exported_image* image)
+    {
+        QMutexLocker locker(&mutex);
+        auto it = holds.find(image);
+        if (it == holds.end() || --it->second)
+            return;
+        holds.erase(it);
+        if (!deferred.erase(image) || !exportable)
+            return;
 
-    if (!eglBindAPI(EGL_OPENGL_ES_API) || !wpe_fdo_initialize_for_egl_display(eglDisplay))
-        return nullptr;
+        // Frames are dropped on any thread, while the exportable belongs to the
+        // GUI thread the backend lives on, as does its main loop.
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [leases = shared_from_this(), image] {
+            QMutexLocker locker(&leases->mutex);
+            if (leases->exportable)
+                wpe_view_backend_exportable_fdo_egl_dispatch_release_exported_image(leases->exportable, image);
+        }, Qt::QueuedConnection);
+    }
 
-    static const EGLint configAttributes[13] = {
-        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
-        EGL_RED_SIZE, 1,
-        EGL_GREEN_SIZE, 1,
-        EGL_BLUE_SIZE, 1,
-        EGL_ALPHA_SIZE, 1,
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-        EGL_NONE
-    };
+    QMutex mutex;
+    struct wpe_view_backend_exportable_fdo* exportable { nullptr };
+    std::unordered_map<struct wpe_fdo_egl_exported_image*, unsigned> holds;
+    std::unordered_set<struct wpe_fdo_egl_exported_image*> deferred;
+};
+
+// GL objects of a backend, deleted on the thread of the context that created them.
+struct GLResources {
+    GLuint texture { 0 };
+    GLuint readFramebuffer { 0 };
+    GLuint scaleFramebuffer { 0 };
+    GLuint scaleRenderbuffer { 0 };
+    std::vector<std::pair<GLuint, void*>> readbacks;
+
+    bool isEmpty() const { return !texture && !readFramebuffer && !scaleFramebuffer && !scaleRenderbuffer && readbacks.empty(); }
+
+    void release(QOpenGLContext* context)
+    {
+        QOpenGLFunctions* glFunctions = context->functions();
+        if (texture)
+            glFunctions->glDeleteTextures(1, &texture);
+        if (readFramebuffer)
+            glFunctions->glDeleteFramebuffers(1, &readFramebuffer);
+        if (scaleFramebuffer)
+            glFunctions->glDeleteFramebuffers(1, &scaleFramebuffer);
+        if (scaleRenderbuffer)
+            glFunctions->glDeleteRenderbuffers(1, &scaleRenderbuffer);
+        for (auto& readback : readbacks) {
+            glFunctions->glDeleteBuffers(1, &readback.first);
+            context->extraFunctions()->glDeleteSync(static_cast<GLsync>(readback.second));
+        }
+    }
+};
 
-    EGLint count = 0;
-    if (!eglGetConfigs(eglDisplay, nullptr, 0, &count) || count < 1)
-        return nullptr;
+class GLResourcesReleaseJob final : public QRunnable {
+public:
+    explicit GLResourcesReleaseJob(GLResources&& resources)
+        : m_resources(std::move(resources))
+    {
+    }
 
-    EGLConfig eglConfig;
-    EGLint matched = 0;
-    EGLContext eglContext = nullptr;
-    if (eglChooseConfig(eglDisplay, configAttributes, &eglConfig, 1, &matched) && !!matched) {
-        static const EGLint contextAttributes[3] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
-        eglContext = eglCreateContext(eglDisplay, eglConfig, nullptr, contextAttributes);
+    void run() override
+    {
+        if (auto* context = QOpenGLContext::currentContext())
+            m_resources.release(context);
     }
 
-    if (!eglContext)
+private:
+    GLResources m_resources;
+};
+
+std::unique_ptr<WPEQtViewBackend> WPEQtViewBackend::create(const QSizeF& size, QPointer<QOpenGLContext> context, EGLDisplay eglDisplay, QPointer<WPEQtView> view)
+{
+    if (!context || !view)
+        return nullptr;
+
+    auto& factory = WPEQtBackendFactory::singleton();
+    if (!factory.initialize(eglDisplay))
         return nullptr;
 
-    return std::make_unique<WPEQtViewBackend>(size, eglDisplay, eglContext, context, view);
+    return std::make_unique<WPEQtViewBackend>(size, eglDisplay, factory.sharedContext(), context, view);
 }
 
 WPEQtViewBackend::WPEQtViewBackend(const QSizeF& size, EGLDisplay display, EGLContext eglContext, QPointer<QOpenGLContext> context, QPointer<WPEQtView> view)
     : m_eglDisplay(display)
     , m_eglContext(eglContext)
     , m_view(view)
+    , m_context(context)
+    , m_window(view->window())
     , m_size(size)
 {
-    wpe_loader_init("libWPEBackend-fdo-1.0.so");
-
-    imageTargetTexture2DOES = reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(eglGetProcAddress("glEGLImageTargetTexture2DOES"));
-
-    static const char* vertexShaderSource =
-        "attribute vec2 pos;\n"
-        "attribute vec2 texture;\n"
-        "varying vec2 v_texture;\n"
-        "void main() {\n"
-        "  v_texture = texture;\n"
-        "  gl_Position = vec4(pos, 0, 1);\n"
-        "}\n";
-    static const char* fragmentShaderSource =
-        "precision mediump float;\n"
-        "uniform sampler2D u_texture;\n"
-        "varying vec2 v_texture;\n"
-        "void main() {\n"
-        "  gl_FragColor = texture2D(u_texture, v_texture);\n"
-        "}\n";
-
-    QOpenGLFunctions* glFunctions = context->functions();
-    GLuint vertexShader = glFunctions->glCreateShader(GL_VERTEX_SHADER);
-    glFunctions->glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glFunctions->glCompileShader(vertexShader);
-
-    GLuint fragmentShader = glFunctions->glCreateShader(GL_FRAGMENT_SHADER);
-    glFunctions->glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glFunctions->glCompileShader(fragmentShader);
-
-    m_program = glFunctions->glCreateProgram();
-    glFunctions->glAttachShader(m_program, vertexShader);
-    glFunctions->glAttachShader(m_program, fragmentShader);
-    glFunctions->glLinkProgram(m_program);
-
-    glFunctions->glBindAttribLocation(m_program, 0, "pos");
-    glFunctions->glBindAttribLocation(m_program, 1, "texture");
-    m_textureUniform = glFunctions->glGetUniformLocation(m_program, "u_texture");
-
     static struct wpe_view_backend_exportable_fdo_egl_client exportableClient = {
         // export_egl_image
         nullptr,
@@ -126,6 +159,8 @@ WPEQtViewBackend::WPEQtViewBackend(const QSizeF& size, EGLDisplay display, EGLCo
     };
 
     m_exportable = wpe_view_backend_exportable_fdo_egl_create(&exportableClient, this, m_size.width(), m_size.height());
+    m_imageLeases = std::make_shared<ImageLeases>();
+    m_imageLeases->exportable = m_exportable;
 
     wpe_view_backend_add_activity_state(backend(), wpe_view_activity_state_visible | wpe_view_activity_state_focused | wpe_view_activity_state_in_window);
 
@@ -135,13 +170,57 @@ WPEQtViewBackend::WPEQtViewBackend(const QSizeF& size, EGLDisplay display, EGLCo
 
 WPEQtViewBackend::~WPEQtViewBackend()
 {
+    cancelSnapshots();
+    releaseGLResources();
+
     if (m_lockedImage)
-        wpe_view_backend_exportable_fdo_egl_dispatch_release_exported_image(m_exportable, m_lockedImage);
+        releaseImage(m_lockedImage);
     if (m_lockedImageOld)
-        wpe_view_backend_exportable_fdo_egl_dispatch_release_exported_image(m_exportable, m_lockedImageOld);
+        releaseImage(m_lockedImageOld);
 
+    {
+        // Frames still held by streams outlive the exportable; their release becomes a no-op.
+        QMutexLocker locker(&m_imageLeases->mutex);
+        m_imageLeases->exportable = nullptr;
+    }
     wpe_view_backend_exportable_fdo_destroy(m_exportable);
-    eglDestroyContext(m_eglDisplay, m_eglContext);
+}
+
+// The backend is destroyed along with its web view, on the GUI thread, while
+// its GL objects belong to the scene graph context, which lives on the render
+// thread with the threaded render loop.
+void WPEQtViewBackend::releaseGLResources()
+{
+    GLResources resources;
+    resources.texture = m_textureId;
+    resources.readFramebuffer = m_readFramebuffer;
+    resources.scaleFramebuffer = m_scaleFramebuffer;
+    resources.scaleRenderbuffer = m_scaleRenderbuffer;
+    for (auto& readback : m_pendingReadbacks)
+        resources.readbacks.emplace_back(readback.buffer, readback.fence);
+    m_pendingReadbacks.clear();
+    m_textureId = m_readFramebuffer = m_scaleFramebuffer = m_scaleRenderbuffer = 0;
+
+    // Objects of a context that is already gone were destroyed with it.
+    if (resources.isEmpty() || !m_context)
+        return;
+
+    if (m_context->thread() == QThread::currentThread()) {
+        QSurface* oldSurface = m_context->surface();
+        if (m_context->makeCurrent(&m_surface)) {
+            resources.release(m_context);
+            if (oldSurface)
+                m_context->makeCurrent(oldSurface);
+            else
+                m_context->doneCurrent();
+        }
+        return;
+    }
+
+    if (m_window) {
+        m_window->scheduleRenderJob(new GLResourcesReleaseJob(std::move(resources)), QQuickWindow::BeforeSynchronizingStage);
+        m_window->update();
+    }
 }
 
 void WPEQtViewBackend::setScaleFactor(float factor)
@@ -186,12 +265,15 @@ GLuint WPEQtViewBackend::texture(QOpenGLContext* context)
     glFunctions->glClearColor(1, 0, 0, 1);
     glFunctions->glClear(GL_COLOR_BUFFER_BIT);
 
-    glFunctions->glUseProgram(m_program);
+    auto& factory = WPEQtBackendFactory::singleton();
+    const auto program = factory.program(context);
+    glFunctions->glUseProgram(program.id);
 
     glFunctions->glActiveTexture(GL_TEXTURE0);
     glFunctions->glBindTexture(GL_TEXTURE_2D, m_textureId);
-    imageTargetTexture2DOES(GL_TEXTURE_2D, wpe_fdo_egl_exported_image_get_egl_image(m_lockedImage));
-    glFunctions->glUniform1i(m_textureUniform, 0);
+    factory.imageTargetTexture2DOES()(GL_TEXTURE_2D, wpe_fdo_egl_exported_image_get_egl_image(m_lockedImage));
+    m_textureSize = QSize(wpe_fdo_egl_exported_image_get_width(m_lockedImage), wpe_fdo_egl_exported_image_get_height(m_lockedImage));
+    glFunctions->glUniform1i(program.textureUniform, 0);
 
     static const GLfloat vertices[4][2] = {
         { -1.0, 1.0  },
@@ -220,7 +302,7 @@ GLuint WPEQtViewBackend::texture(QOpenGLContext* context)
 
     wpe_view_backend_exportable_fdo_dispatch_frame_complete(m_exportable);
     if (m_lockedImageOld)
-        wpe_view_backend_exportable_fdo_egl_dispatch_release_exported_image(m_exportable, m_lockedImageOld);
+        releaseImage(m_lockedImageOld);
     m_lockedImageOld = m_lockedImage;
     m_lockedImage = nullptr;
 
@@ -228,12 +310,216 @@ GLuint WPEQtViewBackend::texture(QOpenGLContext* context)
     return m_textureId;
 }
 
+static bool hasAsyncReadback(QOpenGLContext* context)
+{
+    // Pixel pack buffers, fences and framebuffer blits are core in both GLES 3 and desktop GL 3.
+    return context->format().majorVersion() >= 3;
+}
+
+void WPEQtViewBackend::requestSnapshot(const QSize& size, SnapshotCallback&& callback)
+{
+    m_snapshotRequests.push_back({ size, std::move(callback) });
+    if (m_view)
+        m_view->triggerUpdate();
+}
+
+void WPEQtViewBackend::processSnapshots(QOpenGLContext* context)
+{
+    if (m_snapshotRequests.empty() && m_pendingReadbacks.empty())
+        return;
+
+    if (!m_textureId || m_textureSize.isEmpty() || !hasValidSurface()) {
+        // Nothing has been exported yet, keep the requests around until the first frame arrives.
+        return;
+    }
+
+    QSurface* oldSurface = context->surface();
+    context->makeCurrent(&m_surface);
+
+    auto pendingReadbacks = std::move(m_pendingReadbacks);
+    m_pendingReadbacks.clear();
+    for (auto& readback : pendingReadbacks) {
+        if (!finishReadback(context, readback))
+            m_pendingReadbacks.push_back(std::move(readback));
+    }
+
+    auto requests = std::move(m_snapshotRequests);
+    m_snapshotRequests.clear();
+    for (auto& request : requests)
+        startReadback(context, std::move(request));
+
+    context->makeCurrent(oldSurface);
+
+    // Keep frames coming until every fence has been observed, otherwise an idle page would never deliver.
+    if (!m_pendingReadbacks.empty() && m_view)
+        m_view->triggerUpdate();
+}
+
+void WPEQtViewBackend::startReadback(QOpenGLContext* context, SnapshotRequest&& request)
+{
+    QSize size = m_textureSize;
+    if (request.size.isValid() && !request.size.isEmpty())
+        size = m_textureSize.scaled(request.size, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+
+    QOpenGLFunctions* glFunctions = context->functions();
+    if (!m_readFramebuffer)
+        glFunctions->glGenFramebuffers(1, &m_readFramebuffer);
+    glFunctions->glBindFramebuffer(GL_FRAMEBUFFER, m_readFramebuffer);
+    glFunctions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textureId, 0);
+
+    if (!hasAsyncReadback(context)) {
+        // GLES 2 fallback: synchronous read back at full size, scaled on the CPU.
+        QImage image(m_textureSize, QImage::Format_RGBA8888_Premultiplied);
+        glFunctions->glReadPixels(0, 0, m_textureSize.width(), m_textureSize.height(), GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+        glFunctions->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (size != m_textureSize)
+            image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        deliverSnapshot(std::move(request.callback), std::move(image));
+        return;
+    }
+
+    QOpenGLExtraFunctions* extraFunctions = context->extraFunctions();
+    if (size != m_textureSize) {
+        // Downscale on the GPU so only the thumbnail-sized buffer crosses the bus.
+        if (!m_scaleFramebuffer) {
+            glFunctions->glGenFramebuffers(1, &m_scaleFramebuffer);
+            glFunctions->glGenRenderbuffers(1, &m_scaleRenderbuffer);
+        }
+        glFunctions->glBindFramebuffer(GL_FRAMEBUFFER, m_scaleFramebuffer);
+        glFunctions->glBindRenderbuffer(GL_RENDERBUFFER, m_scaleRenderbuffer);
+        if (m_scaleRenderbufferSize != size) {
+            glFunctions->glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.width(), size.height());
+            glFunctions->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_scaleRenderbuffer);
+            m_scaleRenderbufferSize = size;
+        }
+        glFunctions->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        extraFunctions->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFramebuffer);
+        extraFunctions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_scaleFramebuffer);
+        extraFunctions->glBlitFramebuffer(0, 0, m_textureSize.width(), m_textureSize.height(),
+            0, 0, size.width(), size.height(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glFunctions->glBindFramebuffer(GL_FRAMEBUFFER, m_scaleFramebuffer);
+    }
+
+    PendingReadback readback;
+    readback.size = size;
+    readback.callback = std::move(request.callback);
+
+    glFunctions->glGenBuffers(1, &readback.buffer);
+    glFunctions->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glFunctions->glBufferData(GL_PIXEL_PACK_BUFFER, size.width() * size.height() * 4, nullptr, GL_STREAM_READ);
+    glFunctions->glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glFunctions->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glFunctions->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    readback.fence = extraFunctions->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFunctions->glFlush();
+
+    m_pendingReadbacks.push_back(std::move(readback));
+}
+
+bool WPEQtViewBackend::finishReadback(QOpenGLContext* context, PendingReadback& readback)
+{
+    QOpenGLFunctions* glFunctions = context->functions();
+    QOpenGLExtraFunctions* extraFunctions = context->extraFunctions();
+
+    auto fence = static_cast<GLsync>(readback.fence);
+    GLenum status = extraFunctions->glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+        return false;
+    extraFunctions->glDeleteSync(fence);
+
+    QImage image;
+    if (status != GL_WAIT_FAILED) {
+        const int byteCount = readback.size.width() * readback.size.height() * 4;
+        glFunctions->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        if (auto* data = extraFunctions->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, byteCount, GL_MAP_READ_BIT)) {
+            image = QImage(readback.size, QImage::Format_RGBA8888_Premultiplied);
+            std::memcpy(image.bits(), data, byteCount);
+            extraFunctions->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glFunctions->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    glFunctions->glDeleteBuffers(1, &readback.buffer);
+
+    deliverSnapshot(std::move(readback.callback), std::move(image));
+    return true;
+}
+
+// Requests that can no longer be served, because the view stopped rendering
+// or lost its content, complete with a null image rather than never. Read
+// backs already in flight keep their buffers until the next frame.
+void WPEQtViewBackend::cancelSnapshots()
+{
+    auto requests = std::move(m_snapshotRequests);
+    m_snapshotRequests.clear();
+    for (auto& request : requests)
+        deliverSnapshot(std::move(request.callback), QImage());
+
+    for (auto& readback : m_pendingReadbacks) {
+        SnapshotCallback callback = std::move(readback.callback);
+        readback.callback = nullptr;
+        deliverSnapshot(std::move(callback), QImage());
+    }
+}
+
+void WPEQtViewBackend::deliverSnapshot(SnapshotCallback&& callback, QImage&& image)
+{
+    if (!callback)
+        return;
+
+    // Read backs complete on the render thread; callbacks always run on the GUI
+    // thread, even once the view is gone, so that every request completes.
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [callback = std::move(callback), image = std::move(image)] {
+        callback(image);
+    }, Qt::QueuedConnection);
+}
+
+void WPEQtViewBackend::releaseImage(struct wpe_fdo_egl_exported_image* image)
+{
+    m_imageLeases->release(image);
+}
+
+std::shared_ptr<const WPEQtViewFrame> WPEQtViewBackend::leaseFrame(struct wpe_fdo_egl_exported_image* image)
+{
+    m_imageLeases->hold(image);
+    std::shared_ptr<ImageLeases> leases = m_imageLeases;
+    auto lease = std::shared_ptr<void>(image, [leases](void* image) {
+        leases->drop(static_cast<struct wpe_fdo_egl_exported_image*>(image));
+    });
+
+    const QSize size(wpe_fdo_egl_exported_image_get_width(image), wpe_fdo_egl_exported_image_get_height(image));
+    return std::make_shared<const WPEQtViewFrame>(size, wpe_fdo_egl_exported_image_get_egl_image(image), std::move(lease));
+}
+
+// Releases the images exported by a web process that went away, so they
+// are neither kept alive nor presented again. The view shows no content
+// until a new process exports its first frame.
+void WPEQtViewBackend::discardFrames()
+{
+    if (m_lockedImage)
+        releaseImage(m_lockedImage);
+    if (m_lockedImageOld)
+        releaseImage(m_lockedImageOld);
+    m_lockedImage = nullptr;
+    m_lockedImageOld = nullptr;
+    m_framesDiscarded = true;
+    cancelSnapshots();
+}
+
 void WPEQtViewBackend::displayImage(struct wpe_fdo_egl_exported_image* image)
 {
     RELEASE_ASSERT(!m_lockedImage);
     m_lockedImage = image;
-    if (m_view)
+    m_framesDiscarded = false;
+    if (m_view) {
+        for (auto& stream : m_view->m_frameStreams) {
+            if (stream)
+                stream->offerFrame(*this, image);
+        }
+        m_view->didDisplayFrame();
         m_view->triggerUpdate();
+    }
 }
 
 uint32_t WPEQtViewBackend::modifiers() const
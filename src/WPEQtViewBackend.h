@@ -25,17 +25,22 @@
 #include <epoxy/egl.h>
 
 #include <QHoverEvent>
+#include <QImage>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
 #include <QPointer>
+#include <QQuickWindow>
 #include <QWheelEvent>
 #include <wpe/fdo-egl.h>
 #include <wpe/fdo.h>
+#include <functional>
 #include <memory>
+#include <vector>
 
 class WPEQtView;
+class WPEQtViewFrame;
 
 class Q_DECL_EXPORT WPEQtViewBackend {
 public:
@@ -49,6 +54,16 @@ public:
     GLuint texture(QOpenGLContext*);
     bool hasValidSurface() const { return m_surface.isValid(); };
 
+    using SnapshotCallback = std::function<void(const QImage&)>;
+    void requestSnapshot(const QSize&, SnapshotCallback&&);
+    void processSnapshots(QOpenGLContext*);
+    void cancelSnapshots();
+
+    std::shared_ptr<const WPEQtViewFrame> leaseFrame(struct wpe_fdo_egl_exported_image*);
+
+    void discardFrames();
+    bool hasFrame() const { return !m_framesDiscarded; };
+
     void dispatchHoverEnterEvent(QHoverEvent*);
     void dispatchHoverLeaveEvent(QHoverEvent*);
     void dispatchHoverMoveEvent(QHoverEvent*);
@@ -65,7 +80,26 @@ public:
     struct wpe_view_backend* backend() const { return wpe_view_backend_exportable_fdo_get_view_backend(m_exportable); };
 
 private:
+    struct SnapshotRequest {
+        QSize size;
+        SnapshotCallback callback;
+    };
+
+    struct PendingReadback {
+        QSize size;
+        SnapshotCallback callback;
+        GLuint buffer { 0 };
+        void* fence { nullptr };
+    };
+
+    struct ImageLeases;
+
     void displayImage(struct wpe_fdo_egl_exported_image*);
+    void releaseImage(struct wpe_fdo_egl_exported_image*);
+    void startReadback(QOpenGLContext*, SnapshotRequest&&);
+    bool finishReadback(QOpenGLContext*, PendingReadback&);
+    void deliverSnapshot(SnapshotCallback&&, QImage&&);
+    void releaseGLResources();
     uint32_t modifiers() const;
     void dispatchTouches();
 
@@ -74,14 +108,23 @@ private:
     struct wpe_view_backend_exportable_fdo* m_exportable { nullptr };
     struct wpe_fdo_egl_exported_image* m_lockedImage { nullptr };
     struct wpe_fdo_egl_exported_image* m_lockedImageOld { nullptr };
+    std::shared_ptr<ImageLeases> m_imageLeases;
 
     QPointer<WPEQtView> m_view;
+    QPointer<QOpenGLContext> m_context;
+    QPointer<QQuickWindow> m_window;
     QOffscreenSurface m_surface;
     QSizeF m_size;
     GLuint m_textureId { 0 };
-    unsigned m_program { 0 };
-    unsigned m_textureUniform { 0 };
+    QSize m_textureSize;
+    GLuint m_readFramebuffer { 0 };
+    GLuint m_scaleFramebuffer { 0 };
+    GLuint m_scaleRenderbuffer { 0 };
+    QSize m_scaleRenderbufferSize;
+    std::vector<SnapshotRequest> m_snapshotRequests;
+    std::vector<PendingReadback> m_pendingReadbacks;
     float m_scale = 1.0;
+    bool m_framesDiscarded { false };
 
     bool m_hovering { false };
     uint32_t m_mouseModifiers { 0 };
@@ -24,6 +24,8 @@
 #include "WPEQtView.h"
 #include "WPEQtViewLoadRequestPrivate.h"
 
+#include <chrono>
+
 /*!
   \qmltype WPEViewLoadRequest
   \instantiates WPEQtViewLoadRequest
@@ -31,7 +33,19 @@
 
   \brief A utility type for \l {WPEView}'s \l {WPEView::}{loadingChanged()} signal.
 
-  The WPEViewLoadRequest type contains load status information for the requested URL.
+  The WPEViewLoadRequest type contains load status information for the requested URL,
+  along with timestamps of the load phases and the navigation timing reported by
+  the page.
+
+  A WPEViewLoadRequest describes a whole navigation: the same object is passed to
+  every \l {WPEView::}{loadingChanged()} emission of a navigation and it is
+  recycled by the view for later navigations, so it should not be retained past
+  the next load. The \c updated() signal is emitted whenever its data changes
+  after the load status was reported, for instance once the first frame of the
+  new page is displayed or once the navigation timing becomes available.
+
+  All timestamps are expressed in milliseconds on the monotonic clock, and are
+  \c -1 for phases that have not been reached.
 
   \sa {WPEView::loadingChanged()}{WPEView.loadingChanged()}
 */
@@ -88,3 +102,103 @@ QString WPEQtViewLoadRequest::errorString() const
     Q_D(const WPEQtViewLoadRequest);
     return d->m_errorString;
 }
+
+/*!
+  Returns the current time of the monotonic clock used for the load request
+  timestamps, in milliseconds.
+*/
+qreal WPEQtViewLoadRequest::monotonicTime()
+{
+    using namespace std::chrono;
+    return duration_cast<duration<qreal, std::milli>>(steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+  \qmlproperty real WPEView::WPEViewLoadRequest::startedTime
+  \readonly
+
+  The time at which the navigation started.
+*/
+qreal WPEQtViewLoadRequest::startedTime() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_startedTime;
+}
+
+/*!
+  \qmlproperty real WPEView::WPEViewLoadRequest::redirectedTime
+  \readonly
+
+  The time of the last server redirection of the navigation.
+
+  \sa redirectCount
+*/
+qreal WPEQtViewLoadRequest::redirectedTime() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_redirectedTime;
+}
+
+/*!
+  \qmlproperty real WPEView::WPEViewLoadRequest::committedTime
+  \readonly
+
+  The time at which the first data of the page was received and the
+  navigation was committed.
+*/
+qreal WPEQtViewLoadRequest::committedTime() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_committedTime;
+}
+
+/*!
+  \qmlproperty real WPEView::WPEViewLoadRequest::finishedTime
+  \readonly
+
+  The time at which the navigation finished, successfully or not.
+*/
+qreal WPEQtViewLoadRequest::finishedTime() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_finishedTime;
+}
+
+/*!
+  \qmlproperty real WPEView::WPEViewLoadRequest::firstVisuallyNonEmptyTime
+  \readonly
+
+  The time at which the first frame of the new page was handed over to the
+  view after the navigation was committed.
+*/
+qreal WPEQtViewLoadRequest::firstVisuallyNonEmptyTime() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_firstVisuallyNonEmptyTime;
+}
+
+/*!
+  \qmlproperty int WPEView::WPEViewLoadRequest::redirectCount
+  \readonly
+
+  The number of server redirections of the navigation.
+*/
+int WPEQtViewLoadRequest::redirectCount() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_redirectCount;
+}
+
+/*!
+  \qmlproperty var WPEView::WPEViewLoadRequest::navigationTiming
+  \readonly
+
+  The \c PerformanceNavigationTiming entry reported by the page once the
+  navigation succeeded, as a map of its attributes. The entry times are
+  relative to the page's time origin. Empty until the page reported it.
+*/
+QVariantMap WPEQtViewLoadRequest::navigationTiming() const
+{
+    Q_D(const WPEQtViewLoadRequest);
+    return d->m_navigationTiming;
+}
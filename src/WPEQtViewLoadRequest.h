@@ -28,9 +28,16 @@ class WPEQtViewLoadRequestPrivate;
 
 class WPEQtViewLoadRequest : public QObject {
     Q_OBJECT
-    Q_PROPERTY(QUrl url READ url)
-    Q_PROPERTY(WPEQtView::LoadStatus status READ status)
-    Q_PROPERTY(QString errorString READ errorString)
+    Q_PROPERTY(QUrl url READ url NOTIFY updated)
+    Q_PROPERTY(WPEQtView::LoadStatus status READ status NOTIFY updated)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY updated)
+    Q_PROPERTY(qreal startedTime READ startedTime NOTIFY updated)
+    Q_PROPERTY(qreal redirectedTime READ redirectedTime NOTIFY updated)
+    Q_PROPERTY(qreal committedTime READ committedTime NOTIFY updated)
+    Q_PROPERTY(qreal finishedTime READ finishedTime NOTIFY updated)
+    Q_PROPERTY(qreal firstVisuallyNonEmptyTime READ firstVisuallyNonEmptyTime NOTIFY updated)
+    Q_PROPERTY(int redirectCount READ redirectCount NOTIFY updated)
+    Q_PROPERTY(QVariantMap navigationTiming READ navigationTiming NOTIFY updated)
 
 public:
     ~WPEQtViewLoadRequest();
@@ -38,13 +45,24 @@ public:
     QUrl url() const;
     WPEQtView::LoadStatus status() const;
     QString errorString() const;
+    qreal startedTime() const;
+    qreal redirectedTime() const;
+    qreal committedTime() const;
+    qreal finishedTime() const;
+    qreal firstVisuallyNonEmptyTime() const;
+    int redirectCount() const;
+    QVariantMap navigationTiming() const;
 
     explicit WPEQtViewLoadRequest(const WPEQtViewLoadRequestPrivate&);
 
+    static qreal monotonicTime();
+
+Q_SIGNALS:
+    void updated();
+
 private:
     friend class WPEQtView;
 
     Q_DECLARE_PRIVATE(WPEQtViewLoadRequest)
     QScopedPointer<WPEQtViewLoadRequestPrivate> d_ptr;
 };
-
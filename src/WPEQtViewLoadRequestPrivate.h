@@ -23,6 +23,7 @@
 #include "WPEQtView.h"
 #include <QtCore/qstring.h>
 #include <QtCore/qurl.h>
+#include <QtCore/qvariant.h>
 
 class WPEQtViewLoadRequestPrivate {
 public:
@@ -34,9 +35,24 @@ public:
     { }
     ~WPEQtViewLoadRequestPrivate() { }
 
+    void reset(quint64 navigationId, const QUrl& url)
+    {
+        *this = WPEQtViewLoadRequestPrivate(url, WPEQtView::LoadStartedStatus, QString());
+        m_navigationId = navigationId;
+    }
+
     QUrl m_url;
     WPEQtView::LoadStatus m_status;
     QString m_errorString;
+
+    quint64 m_navigationId { 0 };
+    qreal m_startedTime { -1 };
+    qreal m_redirectedTime { -1 };
+    qreal m_committedTime { -1 };
+    qreal m_finishedTime { -1 };
+    qreal m_firstVisuallyNonEmptyTime { -1 };
+    int m_redirectCount { 0 };
+    QVariantMap m_navigationTiming;
 };
 
 Q_DECLARE_METATYPE(WPEQtViewLoadRequestPrivate)
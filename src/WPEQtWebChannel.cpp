@@ -0,0 +1,1131 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "config.h"
+#include "WPEQtWebChannel.h"
+
+#include <QJSValue>
+#include <QMetaMethod>
+#include <QMetaProperty>
+#include <QUrl>
+#include <QtEndian>
+#include <limits>
+#include <string.h>
+
+// Values are exchanged in a compact binary format, as ArrayBuffers posted to
+// and returned by a script message handler: a tag byte followed, depending on
+// the tag, by a little-endian int32 or double, or a varint length and the
+// UTF-8 bytes of a string, or a varint count and the items of a list or map.
+enum ValueTag : uchar {
+    NullTag,
+    FalseTag,
+    TrueTag,
+    IntTag,
+    DoubleTag,
+    StringTag,
+    ListTag,
+    MapTag,
+    ObjectTag
+};
+
+static const char scriptMessageHandlerName[] = "wpeqt";
+static const char scriptWorldName[] = "wpeqt-web-channel";
+static const int maxQueuedBatches = 64;
+static const qint64 connectionLifetime = 30 * 1000;
+// Nesting of the lists and maps read from pages, which are read recursively.
+static const int maxValueDepth = 64;
+
+// The message handler only exists in an isolated world, where pages cannot
+// reach it. The relay running there forwards the messages of the bootstrap
+// script of the page, prefixed with the origin of the page: the message
+// becomes the list [origin, message].
+static const char relayScript[] = R"JS((function() {
+    if (!window.webkit || !window.webkit.messageHandlers.wpeqt)
+        return;
+    var handler = window.webkit.messageHandlers.wpeqt;
+    var origin = new TextEncoder().encode(location.origin);
+
+    function varint(bytes, value) {
+        while (value >= 0x80) { bytes.push((value & 0x7f) | 0x80); value = Math.floor(value / 128); }
+        bytes.push(value);
+    }
+
+    function reply(id, ok, value) {
+        document.dispatchEvent(new CustomEvent("wpeqt-reply", { detail: [id, ok, value] }));
+    }
+
+    document.addEventListener("wpeqt-message", function(event) {
+        var id = event.detail[0];
+        var message = new Uint8Array(event.detail[1]);
+        var header = [6, 2, 5];
+        varint(header, origin.length);
+        var bytes = new Uint8Array(header.length + origin.length + message.length);
+        bytes.set(header);
+        bytes.set(origin, header.length);
+        bytes.set(message, header.length + origin.length);
+        handler.postMessage(bytes.buffer).then(function(value) {
+            reply(id, true, value);
+        }, function(error) {
+            reply(id, false, String(error && error.message || error));
+        });
+    });
+    document.addEventListener("wpeqt-ping", function() {
+        document.dispatchEvent(new CustomEvent("wpeqt-ready"));
+    });
+    document.dispatchEvent(new CustomEvent("wpeqt-ready"));
+})();)JS";
+
+static const char bootstrapScript[] = R"JS((function() {
+    if (window.wpeqt)
+        return;
+    var encoder = new TextEncoder();
+    var decoder = new TextDecoder();
+    var channel = { objects: {} };
+    var connection = 0;
+
+    function Writer() { this.bytes = new Uint8Array(256); this.length = 0; }
+    Writer.prototype.reserve = function(size) {
+        if (this.length + size <= this.bytes.length)
+            return;
+        var bytes = new Uint8Array(Math.max(this.bytes.length * 2, this.length + size));
+        bytes.set(this.bytes);
+        this.bytes = bytes;
+    };
+    Writer.prototype.byte = function(value) { this.reserve(1); this.bytes[this.length++] = value; };
+    Writer.prototype.varint = function(value) {
+        while (value >= 0x80) { this.byte((value & 0x7f) | 0x80); value = Math.floor(value / 128); }
+        this.byte(value);
+    };
+    Writer.prototype.string = function(value) {
+        var bytes = encoder.encode(value);
+        this.varint(bytes.length);
+        this.reserve(bytes.length);
+        this.bytes.set(bytes, this.length);
+        this.length += bytes.length;
+    };
+    Writer.prototype.value = function(value) {
+        if (value === null || value === undefined)
+            this.byte(0);
+        else if (value === false || value === true)
+            this.byte(value ? 2 : 1);
+        else if (typeof value === "number") {
+            var isInt = (value | 0) === value;
+            this.byte(isInt ? 3 : 4);
+            this.reserve(8);
+            var view = new DataView(this.bytes.buffer);
+            if (isInt) { view.setInt32(this.length, value, true); this.length += 4; }
+            else { view.setFloat64(this.length, value, true); this.length += 8; }
+        } else if (typeof value === "string") {
+            this.byte(5);
+            this.string(value);
+        } else if (Array.isArray(value)) {
+            this.byte(6);
+            this.varint(value.length);
+            for (var i = 0; i < value.length; ++i)
+                this.value(value[i]);
+        } else if (value.__id !== undefined) {
+            this.byte(8);
+            this.string(value.__id);
+        } else {
+            var keys = Object.keys(value);
+            this.byte(7);
+            this.varint(keys.length);
+            for (var j = 0; j < keys.length; ++j) { this.string(keys[j]); this.value(value[keys[j]]); }
+        }
+    };
+
+    function Reader(buffer) { this.bytes = new Uint8Array(buffer); this.view = new DataView(buffer); this.position = 0; }
+    Reader.prototype.varint = function() {
+        var value = 0, factor = 1, byte;
+        do { byte = this.bytes[this.position++]; value += (byte & 0x7f) * factor; factor *= 128; } while (byte & 0x80);
+        return value;
+    };
+    Reader.prototype.string = function() {
+        var length = this.varint();
+        var value = decoder.decode(this.bytes.subarray(this.position, this.position + length));
+        this.position += length;
+        return value;
+    };
+    Reader.prototype.value = function() {
+        var tag = this.bytes[this.position++], value, count, i;
+        switch (tag) {
+        case 1: return false;
+        case 2: return true;
+        case 3: value = this.view.getInt32(this.position, true); this.position += 4; return value;
+        case 4: value = this.view.getFloat64(this.position, true); this.position += 8; return value;
+        case 5: return this.string();
+        case 6:
+            count = this.varint();
+            value = new Array(count);
+            for (i = 0; i < count; ++i)
+                value[i] = this.value();
+            return value;
+        case 7:
+            count = this.varint();
+            value = {};
+            for (i = 0; i < count; ++i) { var key = this.string(); value[key] = this.value(); }
+            return value;
+        case 8: return channel.objects[this.string()] || null;
+        default: return null;
+        }
+    };
+
+    // Messages go through the relay of the isolated world, which may be
+    // injected after this script.
+    var relayReady = false;
+    var queue = [];
+    var pending = {};
+    var nextId = 1;
+    document.addEventListener("wpeqt-ready", function() {
+        relayReady = true;
+        queue.splice(0).forEach(function(detail) { document.dispatchEvent(new CustomEvent("wpeqt-message", { detail: detail })); });
+    });
+    document.addEventListener("wpeqt-reply", function(event) {
+        var callbacks = pending[event.detail[0]];
+        if (!callbacks)
+            return;
+        delete pending[event.detail[0]];
+        if (event.detail[1])
+            callbacks[0](event.detail[2]);
+        else
+            callbacks[1](new Error(event.detail[2]));
+    });
+
+    function send(message) {
+        var writer = new Writer();
+        writer.value(message);
+        var id = nextId++;
+        var detail = [id, writer.bytes.buffer.slice(0, writer.length)];
+        var result = new Promise(function(resolve, reject) { pending[id] = [resolve, reject]; });
+        if (relayReady)
+            document.dispatchEvent(new CustomEvent("wpeqt-message", { detail: detail }));
+        else
+            queue.push(detail);
+        return result.then(function(reply) {
+            return reply ? new Reader(reply).value() : null;
+        });
+    }
+
+    function createObject(description) {
+        var object = { __id: description[0] };
+        var values = description[2];
+        var listeners = [];
+        description[1].forEach(function(name, index) {
+            listeners[index] = [];
+            Object.defineProperty(object, name, {
+                enumerable: true,
+                get: function() { return values[index]; },
+                set: function(value) { values[index] = value; send([3, object.__id, index, value]); }
+            });
+            object[name + "Changed"] = {
+                connect: function(callback) { listeners[index].push(callback); },
+                disconnect: function(callback) { listeners[index] = listeners[index].filter(function(c) { return c !== callback; }); }
+            };
+        });
+        description[3].forEach(function(name, index) {
+            object[name] = function() {
+                return send([2, object.__id, index, Array.prototype.slice.call(arguments)]).then(function(result) {
+                    if (!result[0])
+                        throw new Error(result[1]);
+                    return result[1];
+                });
+            };
+        });
+        object.__update = function(index, value) {
+            values[index] = value;
+            listeners[index].forEach(function(callback) { callback(value); });
+        };
+        return object;
+    }
+
+    function init() {
+        return send([0]).then(function(reply) {
+            connection = reply[0];
+            var objects = {};
+            channel.objects = objects;
+            reply[1].forEach(function(description) { objects[description[0]] = createObject(description); });
+            return channel;
+        });
+    }
+
+    // Updates are batched by the application and returned to a pending poll;
+    // an entry with an empty object identifier means the objects changed.
+    function poll() {
+        send([1, connection]).then(function(batches) {
+            for (var i = 0; i < batches.length; ++i) {
+                var batch = batches[i];
+                for (var j = 0; j < batch.length; j += 3) {
+                    if (batch[j] === "") {
+                        init().then(poll);
+                        return;
+                    }
+                    var object = channel.objects[batch[j]];
+                    if (object)
+                        object.__update(batch[j + 1], batch[j + 2]);
+                }
+            }
+            poll();
+        }, function() {
+            setTimeout(function() { init().then(poll); }, 1000);
+        });
+    }
+
+    document.dispatchEvent(new CustomEvent("wpeqt-ping"));
+    var ready = init();
+    ready.then(poll);
+    Object.defineProperty(window, "wpeqt", { value: Object.freeze({ webChannel: ready }) });
+})();)JS";
+
+static void writeVarint(QByteArray& data, quint64 value)
+{
+    while (value >= 0x80) {
+        data.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    data.append(static_cast<char>(value));
+}
+
+static void writeString(QByteArray& data, const QString& value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    writeVarint(data, utf8.size());
+    data.append(utf8);
+}
+
+template<typename T> static void writeLittleEndian(QByteArray& data, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    data.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+static bool readVarint(const uchar*& data, const uchar* end, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        const uchar byte = *data++;
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static bool readString(const uchar*& data, const uchar* end, QString& value)
+{
+    quint64 length = 0;
+    if (!readVarint(data, end, length) || length > static_cast<quint64>(end - data))
+        return false;
+    value = QString::fromUtf8(reinterpret_cast<const char*>(data), length);
+    data += length;
+    return true;
+}
+
+static bool isQObjectType(const QVariant& value)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    return value.metaType().flags() & QMetaType::PointerToQObject;
+#else
+    return QMetaType::typeFlags(value.userType()) & QMetaType::PointerToQObject;
+#endif
+}
+
+void WPEQtWebChannel::writeValue(QByteArray& data, const QVariant& value) const
+{
+    if (value.userType() == qMetaTypeId<QJSValue>()) {
+        writeValue(data, value.value<QJSValue>().toVariant());
+        return;
+    }
+    if (isQObjectType(value)) {
+        const QString id = m_objectIds.value(value.value<QObject*>());
+        if (id.isEmpty()) {
+            data.append(static_cast<char>(NullTag));
+            return;
+        }
+        data.append(static_cast<char>(ObjectTag));
+        writeString(data, id);
+        return;
+    }
+
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+    case QMetaType::Void:
+        data.append(static_cast<char>(NullTag));
+        break;
+    case QMetaType::Bool:
+        data.append(static_cast<char>(value.toBool() ? TrueTag : FalseTag));
+        break;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Short:
+    case QMetaType::UShort: {
+        const qlonglong integer = value.toLongLong();
+        if (integer >= std::numeric_limits<qint32>::min() && integer <= std::numeric_limits<qint32>::max()) {
+            data.append(static_cast<char>(IntTag));
+            writeLittleEndian<qint32>(data, integer);
+        } else {
+            data.append(static_cast<char>(DoubleTag));
+            writeLittleEndian<double>(data, value.toDouble());
+        }
+        break;
+    }
+    case QMetaType::Double:
+    case QMetaType::Float:
+        data.append(static_cast<char>(DoubleTag));
+        writeLittleEndian<double>(data, value.toDouble());
+        break;
+    case QMetaType::QStringList:
+    case QMetaType::QVariantList: {
+        const QVariantList list = value.toList();
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, list.size());
+        for (const auto& item : list)
+            writeValue(data, item);
+        break;
+    }
+    case QMetaType::QVariantMap:
+    case QMetaType::QVariantHash: {
+        const QVariantMap map = value.toMap();
+        data.append(static_cast<char>(MapTag));
+        writeVarint(data, map.size());
+        for (auto it = map.cbegin(); it != map.cend(); ++it) {
+            writeString(data, it.key());
+            writeValue(data, it.value());
+        }
+        break;
+    }
+    case QMetaType::QUrl:
+        data.append(static_cast<char>(StringTag));
+        writeString(data, value.toUrl().toString());
+        break;
+    default:
+        data.append(static_cast<char>(StringTag));
+        writeString(data, value.toString());
+        break;
+    }
+}
+
+QVariant WPEQtWebChannel::readValue(const uchar*& data, const uchar* end, bool& ok, int depth) const
+{
+    ok = data < end;
+    if (!ok)
+        return QVariant();
+
+    switch (*data++) {
+    case NullTag:
+        return QVariant();
+    case FalseTag:
+        return false;
+    case TrueTag:
+        return true;
+    case IntTag:
+        ok = end - data >= 4;
+        if (!ok)
+            return QVariant();
+        data += 4;
+        return qFromLittleEndian<qint32>(data - 4);
+    case DoubleTag:
+        ok = end - data >= 8;
+        if (!ok)
+            return QVariant();
+        data += 8;
+        return qFromLittleEndian<double>(data - 8);
+    case StringTag: {
+        QString string;
+        ok = readString(data, end, string);
+        return string;
+    }
+    case ListTag: {
+        quint64 count = 0;
+        ok = depth < maxValueDepth && readVarint(data, end, count) && count <= static_cast<quint64>(end - data);
+        QVariantList list;
+        for (quint64 i = 0; ok && i < count; ++i)
+            list.append(readValue(data, end, ok, depth + 1));
+        return list;
+    }
+    case MapTag: {
+        quint64 count = 0;
+        ok = depth < maxValueDepth && readVarint(data, end, count) && count <= static_cast<quint64>(end - data);
+        QVariantMap map;
+        for (quint64 i = 0; ok && i < count; ++i) {
+            QString key;
+            ok = readString(data, end, key);
+            if (ok)
+                map.insert(key, readValue(data, end, ok, depth + 1));
+        }
+        return map;
+    }
+    case ObjectTag: {
+        QString id;
+        ok = readString(data, end, id);
+        return QVariant::fromValue(m_objects.value(id).object.data());
+    }
+    default:
+        ok = false;
+        return QVariant();
+    }
+}
+
+/*!
+  \qmltype WPEWebChannel
+  \instantiates WPEQtWebChannel
+  \inqmlmodule org.wpewebkit.qtwpe
+
+  \brief Exposes QObjects to the JavaScript of the pages of a profile.
+
+  WPEWebChannel publishes objects to the pages loaded by the views of the
+  \l WPEProfile it is set on. Pages get their properties, kept up to date,
+  and their slots and invokable methods, which return promises:
+
+  \qml
+  WPEProfile {
+      webChannel: WPEWebChannel {
+          allowedOrigins: [ "https://app.example.com" ]
+          registeredObjects: { "sensors": sensors }
+      }
+  }
+  \endqml
+
+  \badcode
+  wpeqt.webChannel.then(function(channel) {
+      var sensors = channel.objects.sensors;
+      sensors.temperatureChanged.connect(function(value) { ... });
+      sensors.calibrate(0.5).then(function(result) { ... });
+  });
+  \endcode
+
+  The channel does not run scripts in the pages to deliver updates: the
+  pages keep a request pending on a script message handler, which the
+  channel answers with the properties that changed, at most once per
+  \l updateInterval. Property values are read when the update is sent, so a
+  property changing many times within an interval is sent once. Messages are
+  exchanged in a compact binary format rather than as JSON or script source.
+
+  Properties are sent along with the notification of their change; other
+  signals are not forwarded. Values can be null, booleans, numbers, strings,
+  lists, maps and registered objects. Objects registered or deregistered
+  while pages are connected are announced to them, and the pages fetch the
+  new set of objects.
+
+  Only the pages of \l allowedOrigins get the channel. The script message
+  handler lives in an isolated script world, out of reach of the scripts of
+  pages, and messages are relayed to it with the origin of their page,
+  which is checked by the channel.
+
+  \note Every script of an allowed page, including third-party scripts it
+  includes, can reach the registered objects.
+*/
+WPEQtWebChannel::WPEQtWebChannel(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(16);
+    connect(&m_flushTimer, &QTimer::timeout, this, &WPEQtWebChannel::flush);
+    m_expiryTimer.setInterval(connectionLifetime / 2);
+    connect(&m_expiryTimer, &QTimer::timeout, this, &WPEQtWebChannel::expireConnections);
+}
+
+WPEQtWebChannel::~WPEQtWebChannel()
+{
+    for (auto& connection : m_connections) {
+        if (connection.pendingPoll) {
+            webkit_script_message_reply_return_error_message(connection.pendingPoll, "The channel was destroyed");
+            webkit_script_message_reply_unref(connection.pendingPoll);
+        }
+    }
+    while (!m_managers.isEmpty())
+        detach(m_managers.first().get());
+}
+
+void WPEQtWebChannel::createScripts()
+{
+    // Patterns do not match ports, which are checked along with the origin
+    // of every message.
+    QVector<QByteArray> patterns;
+    for (const auto& origin : m_allowedOrigins) {
+        const QUrl url(origin);
+        if (url.isValid() && !url.scheme().isEmpty())
+            patterns.append(QStringLiteral("%1://%2/*").arg(url.scheme(), url.host()).toUtf8());
+    }
+    if (patterns.isEmpty())
+        return;
+
+    QVector<const char*> allowList;
+    for (const auto& pattern : patterns)
+        allowList.append(pattern.constData());
+    allowList.append(nullptr);
+
+    m_bootstrapScript = webkit_user_script_new(bootstrapScript, WEBKIT_USER_CONTENT_INJECT_TOP_FRAME, WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, allowList.constData(), nullptr);
+    m_relayScript = webkit_user_script_new_for_world(relayScript, WEBKIT_USER_CONTENT_INJECT_TOP_FRAME, WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, scriptWorldName, allowList.constData(), nullptr);
+    for (const auto& manager : m_managers) {
+        webkit_user_content_manager_add_script(manager.get(), m_relayScript);
+        webkit_user_content_manager_add_script(manager.get(), m_bootstrapScript);
+    }
+}
+
+void WPEQtWebChannel::destroyScripts()
+{
+    if (!m_bootstrapScript)
+        return;
+
+    for (const auto& manager : m_managers) {
+        webkit_user_content_manager_remove_script(manager.get(), m_bootstrapScript);
+        webkit_user_content_manager_remove_script(manager.get(), m_relayScript);
+    }
+    webkit_user_script_unref(m_bootstrapScript);
+    webkit_user_script_unref(m_relayScript);
+    m_bootstrapScript = nullptr;
+    m_relayScript = nullptr;
+}
+
+void WPEQtWebChannel::attach(WebKitUserContentManager* manager)
+{
+    if (m_managers.contains(manager))
+        return;
+
+    m_managers.append(manager);
+    g_signal_connect(manager, "script-message-with-reply-received::wpeqt", G_CALLBACK(scriptMessageCallback), this);
+    webkit_user_content_manager_register_script_message_handler_with_reply(manager, scriptMessageHandlerName, scriptWorldName);
+    if (!m_bootstrapScript)
+        createScripts();
+    else {
+        webkit_user_content_manager_add_script(manager, m_relayScript);
+        webkit_user_content_manager_add_script(manager, m_bootstrapScript);
+    }
+}
+
+void WPEQtWebChannel::detach(WebKitUserContentManager* manager)
+{
+    const int index = m_managers.indexOf(manager);
+    if (index < 0)
+        return;
+
+    g_signal_handlers_disconnect_by_func(manager, reinterpret_cast<gpointer>(scriptMessageCallback), this);
+    webkit_user_content_manager_unregister_script_message_handler(manager, scriptMessageHandlerName, scriptWorldName);
+    if (m_bootstrapScript) {
+        webkit_user_content_manager_remove_script(manager, m_bootstrapScript);
+        webkit_user_content_manager_remove_script(manager, m_relayScript);
+    }
+    m_managers.remove(index);
+
+    if (m_managers.isEmpty())
+        destroyScripts();
+}
+
+/*!
+  \qmlproperty map WPEWebChannel::registeredObjects
+
+  The objects published to the pages, by identifier.
+
+  \sa registerObject(), deregisterObject()
+*/
+QVariantMap WPEQtWebChannel::registeredObjects() const
+{
+    QVariantMap objects;
+    for (auto it = m_objects.cbegin(); it != m_objects.cend(); ++it)
+        objects.insert(it.key(), QVariant::fromValue(it->object.data()));
+    return objects;
+}
+
+void WPEQtWebChannel::setRegisteredObjects(const QVariantMap& objects)
+{
+    const QStringList ids = m_objects.keys();
+    for (const auto& id : ids) {
+        if (!objects.contains(id))
+            removeObject(id);
+    }
+    for (auto it = objects.cbegin(); it != objects.cend(); ++it)
+        registerObject(it.key(), it.value().value<QObject*>());
+    Q_EMIT registeredObjectsChanged();
+}
+
+/*!
+  \qmlproperty int WPEWebChannel::updateInterval
+
+  The minimum time in milliseconds between two updates sent to a page. The
+  default value, \c 16, sends at most one update per frame of a 60 Hz
+  display.
+*/
+void WPEQtWebChannel::setUpdateInterval(int updateInterval)
+{
+    updateInterval = std::max(updateInterval, 0);
+    if (updateInterval == m_flushTimer.interval())
+        return;
+
+    m_flushTimer.setInterval(updateInterval);
+    Q_EMIT updateIntervalChanged();
+}
+
+/*!
+  \qmlproperty list<string> WPEWebChannel::allowedOrigins
+
+  The origins of the pages the objects are published to, such as
+  \c {"https://app.example.com"}, compared with the \c location.origin of
+  the pages. Only top-level documents of these origins get the channel;
+  other pages, and frames of other origins within them, cannot reach it.
+  The default, an empty list, publishes the objects to no page.
+
+  Changes apply to the pages loaded afterwards.
+*/
+void WPEQtWebChannel::setAllowedOrigins(const QStringList& allowedOrigins)
+{
+    if (allowedOrigins == m_allowedOrigins)
+        return;
+
+    m_allowedOrigins = allowedOrigins;
+    destroyScripts();
+    if (!m_managers.isEmpty())
+        createScripts();
+    Q_EMIT allowedOriginsChanged();
+}
+
+/*!
+  \qmlmethod void WPEWebChannel::registerObject(string id, QtObject object)
+
+  Publishes \a object to the pages as \c {channel.objects[id]}, replacing the
+  object previously registered with \a id.
+*/
+void WPEQtWebChannel::registerObject(const QString& id, QObject* object)
+{
+    if (id.isEmpty() || !object)
+        return;
+    if (m_objects.value(id).object == object)
+        return;
+
+    removeObject(id);
+    deregisterObject(object);
+
+    static const int propertyChangedIndex = staticMetaObject.indexOfMethod("propertyChanged()");
+    ObjectEntry entry;
+    entry.object = object;
+    const QMetaObject* metaObject = object->metaObject();
+    for (int i = QObject::staticMetaObject.propertyCount(); i < metaObject->propertyCount(); ++i) {
+        const QMetaProperty property = metaObject->property(i);
+        if (!property.isReadable() || !property.isScriptable())
+            continue;
+        if (property.hasNotifySignal()) {
+            auto& properties = entry.propertiesByNotifySignal[property.notifySignalIndex()];
+            if (properties.isEmpty())
+                QMetaObject::connect(object, property.notifySignalIndex(), this, propertyChangedIndex);
+            properties.append(entry.properties.size());
+        }
+        entry.properties.append(i);
+    }
+    for (int i = QObject::staticMetaObject.methodCount(); i < metaObject->methodCount(); ++i) {
+        const QMetaMethod method = metaObject->method(i);
+        if (method.access() != QMetaMethod::Public || (method.methodType() != QMetaMethod::Slot && method.methodType() != QMetaMethod::Method))
+            continue;
+        const QString name = QString::fromLatin1(method.name());
+        int index = entry.methodNames.indexOf(name);
+        if (index < 0) {
+            index = entry.methodNames.size();
+            entry.methodNames.append(name);
+            entry.methods.append({ });
+        }
+        entry.methods[index].append(i);
+    }
+
+    m_objects.insert(id, entry);
+    m_objectIds.insert(object, id);
+    connect(object, &QObject::destroyed, this, [this, object] {
+        removeObject(m_objectIds.value(object));
+        Q_EMIT registeredObjectsChanged();
+    });
+    m_objectsChanged = true;
+    scheduleFlush();
+    Q_EMIT registeredObjectsChanged();
+}
+
+/*!
+  \qmlmethod void WPEWebChannel::deregisterObject(QtObject object)
+
+  Withdraws \a object from the pages.
+*/
+void WPEQtWebChannel::deregisterObject(QObject* object)
+{
+    const QString id = m_objectIds.value(object);
+    if (id.isEmpty())
+        return;
+
+    removeObject(id);
+    Q_EMIT registeredObjectsChanged();
+}
+
+void WPEQtWebChannel::removeObject(const QString& id)
+{
+    auto it = m_objects.find(id);
+    if (it == m_objects.end())
+        return;
+
+    if (QObject* object = it->object.data()) {
+        disconnect(object, nullptr, this, nullptr);
+        m_objectIds.remove(object);
+    } else {
+        for (auto objectId = m_objectIds.begin(); objectId != m_objectIds.end();) {
+            if (objectId.value() == id)
+                objectId = m_objectIds.erase(objectId);
+            else
+                ++objectId;
+        }
+    }
+    m_objects.erase(it);
+    m_dirtyProperties.remove(id);
+    m_objectsChanged = true;
+    scheduleFlush();
+}
+
+void WPEQtWebChannel::propertyChanged()
+{
+    const QString id = m_objectIds.value(sender());
+    const auto it = m_objects.constFind(id);
+    if (it == m_objects.cend())
+        return;
+
+    const QVector<int> properties = it->propertiesByNotifySignal.value(senderSignalIndex());
+    if (properties.isEmpty())
+        return;
+
+    auto& dirty = m_dirtyProperties[id];
+    for (int property : properties)
+        dirty.insert(property);
+    scheduleFlush();
+}
+
+void WPEQtWebChannel::scheduleFlush()
+{
+    if (!m_connections.isEmpty() && !m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void WPEQtWebChannel::expireConnections()
+{
+    // Connections of pages that went away are only noticed by their silence.
+    // Polls pending for a while are answered empty, so that live pages poll
+    // again and are not mistaken for gone ones.
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_connections.begin(); it != m_connections.end();) {
+        if (now - it->lastSeen > connectionLifetime) {
+            if (it->pendingPoll) {
+                webkit_script_message_reply_return_error_message(it->pendingPoll, "Expired");
+                webkit_script_message_reply_unref(it->pendingPoll);
+            }
+            it = m_connections.erase(it);
+            continue;
+        }
+        if (it->pendingPoll && now - it->lastSeen > connectionLifetime / 2)
+            completePoll(*it);
+        ++it;
+    }
+
+    if (m_connections.isEmpty())
+        m_expiryTimer.stop();
+}
+
+void WPEQtWebChannel::flush()
+{
+    expireConnections();
+
+    QByteArray batch;
+    if (m_objectsChanged) {
+        batch.append(static_cast<char>(ListTag));
+        writeVarint(batch, 3);
+        writeValue(batch, QString());
+        writeValue(batch, -1);
+        writeValue(batch, QVariant());
+    } else {
+        int count = 0;
+        for (const auto& properties : m_dirtyProperties)
+            count += properties.size();
+        if (!count)
+            return;
+
+        batch.append(static_cast<char>(ListTag));
+        writeVarint(batch, count * 3);
+        for (auto it = m_dirtyProperties.cbegin(); it != m_dirtyProperties.cend(); ++it) {
+            const ObjectEntry& entry = m_objects[it.key()];
+            for (int property : it.value()) {
+                writeValue(batch, it.key());
+                writeValue(batch, property);
+                writeValue(batch, entry.object ? entry.object->metaObject()->property(entry.properties[property]).read(entry.object) : QVariant());
+            }
+        }
+    }
+    m_objectsChanged = false;
+    m_dirtyProperties.clear();
+    deliver(batch);
+}
+
+void WPEQtWebChannel::snapshot(QByteArray& batch) const
+{
+    int count = 0;
+    for (const auto& entry : m_objects)
+        count += entry.properties.size();
+
+    batch.append(static_cast<char>(ListTag));
+    writeVarint(batch, count * 3);
+    for (auto it = m_objects.cbegin(); it != m_objects.cend(); ++it) {
+        for (int i = 0; i < it->properties.size(); ++i) {
+            writeValue(batch, it.key());
+            writeValue(batch, i);
+            writeValue(batch, it->object ? it->object->metaObject()->property(it->properties[i]).read(it->object) : QVariant());
+        }
+    }
+}
+
+void WPEQtWebChannel::deliver(const QByteArray& batch)
+{
+    for (auto& connection : m_connections) {
+        connection.batches.append(batch);
+        // Pages falling behind get the current values instead of the whole backlog.
+        if (connection.batches.size() > maxQueuedBatches) {
+            connection.batches.clear();
+            QByteArray current;
+            snapshot(current);
+            connection.batches.append(current);
+        }
+        if (connection.pendingPoll)
+            completePoll(connection);
+    }
+}
+
+static void returnValue(WebKitScriptMessageReply* reply, JSCContext* context, const QByteArray& data)
+{
+    void* bytes = g_malloc(data.size());
+    memcpy(bytes, data.constData(), data.size());
+    auto value = adoptGRef(jsc_value_new_array_buffer(context, bytes, data.size(), g_free, bytes));
+    webkit_script_message_reply_return_value(reply, value.get());
+}
+
+void WPEQtWebChannel::completePoll(Connection& connection)
+{
+    QByteArray data;
+    data.append(static_cast<char>(ListTag));
+    writeVarint(data, connection.batches.size());
+    for (const auto& batch : connection.batches)
+        data.append(batch);
+    connection.batches.clear();
+
+    returnValue(connection.pendingPoll, connection.context.get(), data);
+    webkit_script_message_reply_unref(connection.pendingPoll);
+    connection.pendingPoll = nullptr;
+    connection.context = nullptr;
+}
+
+gboolean WPEQtWebChannel::scriptMessageCallback(WebKitUserContentManager*, JSCValue* value, WebKitScriptMessageReply* reply, WPEQtWebChannel* channel)
+{
+    if (!jsc_value_is_array_buffer(value)) {
+        webkit_script_message_reply_return_error_message(reply, "Invalid message");
+        return TRUE;
+    }
+
+    gsize size = 0;
+    const auto* data = static_cast<const uchar*>(jsc_value_array_buffer_get_data(value, &size));
+    bool ok = false;
+    const QVariant envelope = channel->readValue(data, data + size, ok);
+    const QVariantList envelopeList = envelope.toList();
+    if (!ok || envelope.userType() != QMetaType::QVariantList || envelopeList.size() != 2
+        || envelopeList[1].userType() != QMetaType::QVariantList) {
+        webkit_script_message_reply_return_error_message(reply, "Invalid message");
+        return TRUE;
+    }
+
+    // Set by the relay of the isolated world from the location of the page.
+    if (!channel->m_allowedOrigins.contains(envelopeList[0].toString())) {
+        webkit_script_message_reply_return_error_message(reply, "Origin not allowed");
+        return TRUE;
+    }
+
+    channel->handleMessage(envelopeList[1].toList(), reply, jsc_value_get_context(value));
+    return TRUE;
+}
+
+void WPEQtWebChannel::handleMessage(const QVariantList& message, WebKitScriptMessageReply* reply, JSCContext* context)
+{
+    QByteArray data;
+    switch (message.value(0).toInt()) {
+    case InitMessage: {
+        const quint64 connectionId = m_nextConnectionId++;
+        m_connections.insert(connectionId, { nullptr, nullptr, { }, m_clock.elapsed() });
+        if (!m_expiryTimer.isActive())
+            m_expiryTimer.start();
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, 2);
+        writeValue(data, connectionId);
+        describeObjects(data);
+        returnValue(reply, context, data);
+        break;
+    }
+    case PollMessage:
+        poll(message.value(1).toULongLong(), reply, context);
+        break;
+    case InvokeMessage:
+        invoke(message, reply, context);
+        break;
+    case SetPropertyMessage: {
+        const ObjectEntry entry = m_objects.value(message.value(1).toString());
+        const int property = message.value(2).toInt();
+        if (entry.object && property >= 0 && property < entry.properties.size())
+            entry.object->metaObject()->property(entry.properties[property]).write(entry.object, message.value(3));
+        writeValue(data, QVariant());
+        returnValue(reply, context, data);
+        break;
+    }
+    default:
+        webkit_script_message_reply_return_error_message(reply, "Invalid message");
+        break;
+    }
+}
+
+void WPEQtWebChannel::describeObjects(QByteArray& data) const
+{
+    data.append(static_cast<char>(ListTag));
+    writeVarint(data, m_objects.size());
+    for (auto it = m_objects.cbegin(); it != m_objects.cend(); ++it) {
+        const QMetaObject* metaObject = it->object ? it->object->metaObject() : nullptr;
+        QStringList names;
+        QVariantList values;
+        for (int property : it->properties) {
+            const QMetaProperty metaProperty = metaObject ? metaObject->property(property) : QMetaProperty();
+            names.append(QString::fromLatin1(metaProperty.name()));
+            values.append(metaObject ? metaProperty.read(it->object) : QVariant());
+        }
+
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, 4);
+        writeValue(data, it.key());
+        writeValue(data, names);
+        writeValue(data, values);
+        writeValue(data, it->methodNames);
+    }
+}
+
+void WPEQtWebChannel::poll(quint64 connectionId, WebKitScriptMessageReply* reply, JSCContext* context)
+{
+    auto it = m_connections.find(connectionId);
+    if (it == m_connections.end()) {
+        // Unknown or expired connection: ask the page to start over.
+        QByteArray data;
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, 1);
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, 3);
+        writeValue(data, QString());
+        writeValue(data, -1);
+        writeValue(data, QVariant());
+        returnValue(reply, context, data);
+        return;
+    }
+
+    if (it->pendingPoll) {
+        webkit_script_message_reply_return_error_message(it->pendingPoll, "Superseded");
+        webkit_script_message_reply_unref(it->pendingPoll);
+    }
+    it->pendingPoll = webkit_script_message_reply_ref(reply);
+    it->context = context;
+    it->lastSeen = m_clock.elapsed();
+    if (!it->batches.isEmpty())
+        completePoll(*it);
+}
+
+void WPEQtWebChannel::invoke(const QVariantList& message, WebKitScriptMessageReply* reply, JSCContext* context)
+{
+    QByteArray data;
+    auto fail = [&](const char* error) {
+        data.append(static_cast<char>(ListTag));
+        writeVarint(data, 2);
+        writeValue(data, false);
+        writeValue(data, QString::fromLatin1(error));
+        returnValue(reply, context, data);
+    };
+
+    const ObjectEntry entry = m_objects.value(message.value(1).toString());
+    const int methodIndex = message.value(2).toInt();
+    QVariantList arguments = message.value(3).toList();
+    if (!entry.object || methodIndex < 0 || methodIndex >= entry.methods.size()) {
+        fail("Unknown method");
+        return;
+    }
+
+    // Overloads are told apart by their number of arguments.
+    QMetaMethod method;
+    for (int index : entry.methods[methodIndex]) {
+        const QMetaMethod candidate = entry.object->metaObject()->method(index);
+        if (candidate.parameterCount() == arguments.size()) {
+            method = candidate;
+            break;
+        }
+    }
+    if (!method.isValid() || arguments.size() > 10) {
+        fail("Wrong number of arguments");
+        return;
+    }
+
+    QGenericArgument genericArguments[10];
+    for (int i = 0; i < arguments.size(); ++i) {
+        const int type = method.parameterType(i);
+        if (type != QMetaType::QVariant) {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+            arguments[i].convert(QMetaType(type));
+#else
+            arguments[i].convert(type);
+#endif
+            genericArguments[i] = QGenericArgument(method.parameterTypes().at(i).constData(), arguments[i].constData());
+        } else
+            genericArguments[i] = QGenericArgument("QVariant", &arguments[i]);
+    }
+
+    const int returnType = method.returnType();
+    QVariant result;
+    if (returnType == QMetaType::QVariant) {
+        // QML methods return their value as a QVariant.
+    } else if (returnType != QMetaType::Void && returnType != QMetaType::UnknownType) {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        result = QVariant(QMetaType(returnType));
+#else
+        result = QVariant(returnType, nullptr);
+#endif
+    }
+
+    QGenericReturnArgument returnArgument;
+    if (returnType == QMetaType::QVariant)
+        returnArgument = QGenericReturnArgument("QVariant", &result);
+    else if (result.isValid())
+        returnArgument = QGenericReturnArgument(method.typeName(), result.data());
+
+    const bool invoked = method.invoke(entry.object, Qt::DirectConnection, returnArgument,
+        genericArguments[0], genericArguments[1], genericArguments[2], genericArguments[3], genericArguments[4],
+        genericArguments[5], genericArguments[6], genericArguments[7], genericArguments[8], genericArguments[9]);
+    if (!invoked) {
+        fail("Invocation failed");
+        return;
+    }
+
+    data.append(static_cast<char>(ListTag));
+    writeVarint(data, 2);
+    writeValue(data, true);
+    writeValue(data, result);
+    returnValue(reply, context, data);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "config.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+#include <wpe/webkit.h>
+#include <wtf/glib/GRefPtr.h>
+
+class WPEQtWebChannel : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(WPEQtWebChannel)
+    Q_PROPERTY(QVariantMap registeredObjects READ registeredObjects WRITE setRegisteredObjects NOTIFY registeredObjectsChanged)
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged)
+    Q_PROPERTY(QStringList allowedOrigins READ allowedOrigins WRITE setAllowedOrigins NOTIFY allowedOriginsChanged)
+
+public:
+    explicit WPEQtWebChannel(QObject* parent = nullptr);
+    ~WPEQtWebChannel();
+
+    QVariantMap registeredObjects() const;
+    void setRegisteredObjects(const QVariantMap&);
+    int updateInterval() const { return m_flushTimer.interval(); }
+    void setUpdateInterval(int);
+    QStringList allowedOrigins() const { return m_allowedOrigins; }
+    void setAllowedOrigins(const QStringList&);
+
+    Q_INVOKABLE void registerObject(const QString& id, QObject*);
+    Q_INVOKABLE void deregisterObject(QObject*);
+
+    void attach(WebKitUserContentManager*);
+    void detach(WebKitUserContentManager*);
+
+Q_SIGNALS:
+    void registeredObjectsChanged();
+    void updateIntervalChanged();
+    void allowedOriginsChanged();
+
+private Q_SLOTS:
+    void propertyChanged();
+    void flush();
+    void expireConnections();
+
+private:
+    enum MessageType {
+        InitMessage,
+        PollMessage,
+        InvokeMessage,
+        SetPropertyMessage
+    };
+
+    struct ObjectEntry {
+        QPointer<QObject> object;
+        QVector<int> properties;
+        QStringList methodNames;
+        QVector<QVector<int>> methods;
+        QHash<int, QVector<int>> propertiesByNotifySignal;
+    };
+
+    struct Connection {
+        WebKitScriptMessageReply* pendingPoll { nullptr };
+        GRefPtr<JSCContext> context;
+        QList<QByteArray> batches;
+        // Time of the last message of the page.
+        qint64 lastSeen { 0 };
+    };
+
+    static gboolean scriptMessageCallback(WebKitUserContentManager*, JSCValue*, WebKitScriptMessageReply*, WPEQtWebChannel*);
+
+    void handleMessage(const QVariantList&, WebKitScriptMessageReply*, JSCContext*);
+    void describeObjects(QByteArray&) const;
+    void invoke(const QVariantList&, WebKitScriptMessageReply*, JSCContext*);
+    void poll(quint64 connectionId, WebKitScriptMessageReply*, JSCContext*);
+    void completePoll(Connection&);
+    void deliver(const QByteArray& batch);
+    void snapshot(QByteArray&) const;
+    void removeObject(const QString& id);
+    void scheduleFlush();
+    void createScripts();
+    void destroyScripts();
+
+    void writeValue(QByteArray&, const QVariant&) const;
+    QVariant readValue(const uchar*& data, const uchar* end, bool& ok, int depth = 0) const;
+
+    QHash<QString, ObjectEntry> m_objects;
+    QHash<QObject*, QString> m_objectIds;
+    QHash<QString, QSet<int>> m_dirtyProperties;
+    bool m_objectsChanged { false };
+    QHash<quint64, Connection> m_connections;
+    quint64 m_nextConnectionId { 1 };
+    QElapsedTimer m_clock;
+    QTimer m_flushTimer;
+    QTimer m_expiryTimer;
+    QVector<GRefPtr<WebKitUserContentManager>> m_managers;
+    QStringList m_allowedOrigins;
+    WebKitUserScript* m_bootstrapScript { nullptr };
+    WebKitUserScript* m_relayScript { nullptr };
+};
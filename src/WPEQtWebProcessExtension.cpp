@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 The wpewebkit-qt authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+// Web process extension loaded into every web process of the views. It
+// answers the requests of the UI process that only the web process can
+// answer reliably, such as its process identifier, and loads the web
+// process extensions of the application, as a web context only has a
+// single extensions directory.
+
+#include <gio/gio.h>
+#include <gmodule.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wpe/webkit-web-process-extension.h>
+
+static gboolean userMessageReceivedCallback(WebKitWebPage*, WebKitUserMessage* message, gpointer)
+{
+    if (g_strcmp0(webkit_user_message_get_name(message), "wpeqt-get-process-id"))
+        return FALSE;
+
+    // Sandboxed web processes run in their own PID namespace, which the UI
+    // process finds from its inode.
+    struct stat namespaceStat;
+    guint64 pidNamespace = !stat("/proc/self/ns/pid", &namespaceStat) ? namespaceStat.st_ino : 0;
+    webkit_user_message_send_reply(message, webkit_user_message_new("wpeqt-process-id", g_variant_new("(xt)", static_cast<gint64>(getpid()), pidNamespace)));
+    return TRUE;
+}
+
+static void pageCreatedCallback(WebKitWebProcessExtension*, WebKitWebPage* page, gpointer)
+{
+    g_signal_connect(page, "user-message-received", G_CALLBACK(userMessageReceivedCallback), nullptr);
+}
+
+static void loadApplicationExtensions(WebKitWebProcessExtension* extension, const char* directoryPath)
+{
+    GDir* directory = g_dir_open(directoryPath, 0, nullptr);
+    if (!directory)
+        return;
+
+    while (const char* name = g_dir_read_name(directory)) {
+        if (!g_str_has_suffix(name, "." G_MODULE_SUFFIX))
+            continue;
+
+        char* path = g_build_filename(directoryPath, name, nullptr);
+        GModule* module = g_module_open(path, G_MODULE_BIND_LOCAL);
+        if (!module) {
+            g_warning("WPEQt: cannot load web process extension %s: %s", path, g_module_error());
+            g_free(path);
+            continue;
+        }
+        g_free(path);
+
+        using InitializeWithUserDataFunction = void (*)(WebKitWebProcessExtension*, const GVariant*);
+        using InitializeFunction = void (*)(WebKitWebProcessExtension*);
+        gpointer symbol = nullptr;
+        if (g_module_symbol(module, "webkit_web_process_extension_initialize_with_user_data", &symbol) && symbol)
+            reinterpret_cast<InitializeWithUserDataFunction>(symbol)(extension, nullptr);
+        else if (g_module_symbol(module, "webkit_web_process_extension_initialize", &symbol) && symbol)
+            reinterpret_cast<InitializeFunction>(symbol)(extension);
+        else {
+            g_module_close(module);
+            continue;
+        }
+        // Extensions stay loaded for the lifetime of the web process.
+        g_module_make_resident(module);
+    }
+    g_dir_close(directory);
+}
+
+extern "C" G_MODULE_EXPORT void webkit_web_process_extension_initialize_with_user_data(WebKitWebProcessExtension* extension, const GVariant* userData)
+{
+    g_signal_connect(extension, "page-created", G_CALLBACK(pageCreatedCallback), nullptr);
+
+    auto* variant = const_cast<GVariant*>(userData);
+    if (variant && g_variant_is_of_type(variant, G_VARIANT_TYPE_STRING))
+        loadApplicationExtensions(extension, g_variant_get_string(variant, nullptr));
+}